@@ -0,0 +1,552 @@
+#include "route_planner/graph.hpp"
+#include "route_planner/basic_router.hpp"
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/compressed_graph.hpp"
+#include "route_planner/contraction_hierarchy.hpp"
+#include "route_planner/distance_kernels.hpp"
+#include "route_planner/generators.hpp"
+#include "route_planner/hub_labels.hpp"
+#include "route_planner/landmarks.hpp"
+#include "route_planner/map_loader.hpp"
+#include "route_planner/node_order.hpp"
+#include "route_planner/router.hpp"
+#include "route_planner/search_context.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Synthetic-graph benchmark, prints one JSON document
+// Usage: RoutePlannerBench [--sizes 1000,10000] [--families grid,geometric,scalefree]
+//                          [--queries N] [--seed S] [--ch-max-nodes N] [--landmarks N]
+//                          [--orders hilbert,bfs,rcm] [--no-loader] [--output file.json]
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchOptions {
+        std::vector<size_t> sizes = {1000, 10000, 100000};
+        std::vector<std::string> families = {"grid", "geometric", "scalefree"};
+        size_t queries = 1000;
+        unsigned seed = 42;
+        size_t chMaxNodes = 20000; // CH preprocessing is the slowest stage by far
+        size_t landmarks = 16;
+        std::vector<std::string> orders = {"hilbert", "bfs", "rcm"}; // Node layouts rerun against the ID order
+        bool loader = true;
+        std::string output;
+    };
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Peak resident set size of the whole process so far
+    long peakRssKb() {
+#ifdef _WIN32
+        return 0; // Not reported
+#else
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    }
+
+    std::vector<std::string> split(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    bool parseArgs(int argc, char* argv[], BenchOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--sizes" && hasValue) {
+                options.sizes.clear();
+                for (const auto& size : split(argv[++i])) options.sizes.push_back(std::stoull(size));
+            } else if (arg == "--families" && hasValue) {
+                options.families = split(argv[++i]);
+            } else if (arg == "--queries" && hasValue) {
+                options.queries = std::stoull(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--ch-max-nodes" && hasValue) {
+                options.chMaxNodes = std::stoull(argv[++i]);
+            } else if (arg == "--landmarks" && hasValue) {
+                options.landmarks = std::stoull(argv[++i]);
+            } else if (arg == "--orders" && hasValue) {
+                options.orders = split(argv[++i]);
+            } else if (arg == "--no-loader") {
+                options.loader = false;
+            } else if (arg == "--output" && hasValue) {
+                options.output = argv[++i];
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Minimal JSON object writer, enough for flat records
+    class JsonObject {
+    public:
+        JsonObject& add(const std::string& key, const std::string& value) {
+            return raw(key, "\"" + value + "\"");
+        }
+        JsonObject& add(const std::string& key, double value) {
+            std::ostringstream ss;
+            ss.precision(10);
+            if (std::isfinite(value)) ss << value;
+            else ss << "null";
+            return raw(key, ss.str());
+        }
+        JsonObject& add(const std::string& key, size_t value) { return raw(key, std::to_string(value)); }
+        JsonObject& add(const std::string& key, long value) { return raw(key, std::to_string(value)); }
+        JsonObject& add(const std::string& key, const JsonObject& value) { return raw(key, value.str()); }
+
+        std::string str() const { return "{" + body + "}"; }
+
+    private:
+        JsonObject& raw(const std::string& key, const std::string& value) {
+            if (!body.empty()) body += ", ";
+            body += "\"" + key + "\": " + value;
+            return *this;
+        }
+
+        std::string body;
+    };
+
+    // p in [0, 1], nearest-rank
+    double percentile(std::vector<double> sorted, double p) {
+        if (sorted.empty()) return 0.0;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+    }
+
+    JsonObject summary(const std::vector<double>& values) {
+        double sum = 0.0;
+        for (double v : values) sum += v;
+        JsonObject json;
+        json.add("mean", values.empty() ? 0.0 : sum / values.size())
+            .add("p50", percentile(values, 0.50))
+            .add("p90", percentile(values, 0.90))
+            .add("p99", percentile(values, 0.99))
+            .add("max", percentile(values, 1.0));
+        return json;
+    }
+
+    // Hardware cache misses of this thread while a workload runs, via Linux perf events
+    // There is no portable L2 event, so last-level and L1 data read misses are counted
+    // Reported as null where unavailable (other platforms, no PMU in a VM, perf_event_paranoid)
+    class CacheCounters {
+    public:
+        CacheCounters() {
+#ifdef __linux__
+            llcFd = open(PERF_COUNT_HW_CACHE_LL);
+            l1dFd = open(PERF_COUNT_HW_CACHE_L1D);
+#endif
+        }
+
+        ~CacheCounters() {
+#ifdef __linux__
+            if (llcFd != -1) close(llcFd);
+            if (l1dFd != -1) close(l1dFd);
+#endif
+        }
+
+        CacheCounters(const CacheCounters&) = delete;
+        CacheCounters& operator=(const CacheCounters&) = delete;
+
+        void start() {
+            for (int fd : {llcFd, l1dFd}) {
+#ifdef __linux__
+                if (fd == -1) continue;
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+            }
+        }
+
+        // Stop counting and add "llcMisses" / "l1dMisses" to 'json'
+        void stop(JsonObject& json) {
+            json.add("llcMisses", read(llcFd)).add("l1dMisses", read(l1dFd));
+        }
+
+    private:
+#ifdef __linux__
+        static int open(uint64_t cache) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+
+        static double read(int fd) {
+#ifdef __linux__
+            uint64_t count = 0;
+            if (fd != -1) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                if (::read(fd, &count, sizeof(count)) == sizeof(count)) return static_cast<double>(count);
+            }
+#endif
+            (void)fd;
+            return NAN; // Written as null
+        }
+
+        int llcFd = -1;
+        int l1dFd = -1;
+    };
+
+    // One query: returns the route, reports settled nodes through 'settled'
+    using QueryFn = std::function<RoutePlanner::RouteResult(int, int, size_t& settled)>;
+
+    // Run the whole workload through one engine
+    JsonObject runQueries(const std::string& engine, const std::vector<std::pair<int, int>>& pairs, const QueryFn& query) {
+        std::vector<double> latencies, settledCounts;
+        latencies.reserve(pairs.size());
+        settledCounts.reserve(pairs.size());
+        size_t found = 0;
+        double distanceSum = 0.0; // Exact engines must agree on this
+
+        auto start = Clock::now();
+        for (const auto& [s, t] : pairs) {
+            size_t settled = 0;
+            auto queryStart = Clock::now();
+            auto result = query(s, t, settled);
+            latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - queryStart).count());
+            settledCounts.push_back(static_cast<double>(settled));
+            if (result.success) {
+                ++found;
+                distanceSum += result.totalDist;
+            }
+        }
+        double totalMs = elapsedMs(start);
+
+        JsonObject json;
+        json.add("engine", engine)
+            .add("queries", pairs.size())
+            .add("found", found)
+            .add("distanceSum", distanceSum)
+            .add("throughputQps", totalMs > 0 ? pairs.size() / (totalMs / 1000.0) : 0.0)
+            .add("latencyUs", summary(latencies))
+            .add("settled", summary(settledCounts))
+            .add("peakRssKb", peakRssKb());
+        return json;
+    }
+
+    JsonObject stage(const std::string& name, double ms) {
+        JsonObject json;
+        json.add("stage", name).add("ms", ms).add("peakRssKb", peakRssKb());
+        return json;
+    }
+
+    RoutePlanner::Graph generate(const std::string& family, size_t n, unsigned seed) {
+        if (family == "grid") {
+            size_t side = std::max<size_t>(1, static_cast<size_t>(std::round(std::sqrt(static_cast<double>(n)))));
+            return RoutePlanner::Generators::grid(side, side, seed);
+        }
+        if (family == "geometric") return RoutePlanner::Generators::randomGeometric(n, 6.0, seed);
+        return RoutePlanner::Generators::scaleFree(n, 2, seed);
+    }
+
+    // CSV round trip through MapLoader, as the application starts up
+    void benchLoader(const RoutePlanner::Graph& graph, const RoutePlanner::CompactGraph& compact,
+                     std::vector<std::string>& results) {
+        namespace fs = std::filesystem;
+        fs::path dir = fs::temp_directory_path();
+        std::string nodesPath = (dir / "route_planner_bench_nodes.csv").string();
+        std::string edgesPath = (dir / "route_planner_bench_edges.csv").string();
+        std::string snapshotPath = (dir / "route_planner_bench.snap").string();
+        {
+            std::ofstream nodes(nodesPath);
+            std::ofstream edges(edgesPath);
+            nodes.precision(10);
+            edges.precision(10);
+            for (const auto& [id, node] : graph.getAllNodes()) {
+                nodes << id << "," << node.name << "," << node.x << "," << node.y << "\n";
+                for (const auto& edge : node.neighbors) {
+                    // Loader adds both directions, so write each road once
+                    if (id < edge.targetNodeID) edges << id << "," << edge.targetNodeID << "," << edge.distance << "\n";
+                }
+            }
+        }
+
+        RoutePlanner::Graph loaded;
+        auto start = Clock::now();
+        RoutePlanner::MapLoader::loadNodes(nodesPath, loaded);
+        RoutePlanner::MapLoader::loadEdges(edgesPath, loaded);
+        results.push_back(stage("csv_load", elapsedMs(start)).str());
+
+        start = Clock::now();
+        compact.save(snapshotPath);
+        results.push_back(stage("snapshot_save", elapsedMs(start)).str());
+
+        RoutePlanner::CompactGraph mapped;
+        start = Clock::now();
+        RoutePlanner::CompactGraph::load(snapshotPath, mapped);
+        results.push_back(stage("snapshot_load", elapsedMs(start)).str());
+
+        std::remove(nodesPath.c_str());
+        std::remove(edgesPath.c_str());
+        std::remove(snapshotPath.c_str());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--sizes 1000,10000] [--families grid,geometric,scalefree]"
+                  << " [--queries N] [--seed S] [--ch-max-nodes N] [--landmarks N] [--orders hilbert,bfs,rcm]"
+                  << " [--no-loader] [--output file]"
+                  << std::endl;
+        return 1;
+    }
+
+    const std::vector<std::pair<std::string, RoutePlanner::NodeOrder>> knownOrders = {
+        {"hilbert", RoutePlanner::NodeOrder::Hilbert},
+        {"bfs", RoutePlanner::NodeOrder::BreadthFirst},
+        {"rcm", RoutePlanner::NodeOrder::CuthillMcKee}};
+    for (const auto& order : options.orders) {
+        bool known = std::any_of(knownOrders.begin(), knownOrders.end(),
+                                 [&](const auto& entry) { return entry.first == order; });
+        if (!known) {
+            std::cerr << "Unknown order: " << order << " (expected hilbert, bfs or rcm)" << std::endl;
+            return 1;
+        }
+    }
+
+    CacheCounters counters;
+    std::vector<std::string> runs;
+    for (const auto& family : options.families) {
+        for (size_t size : options.sizes) {
+            std::cerr << "[bench] " << family << " n=" << size << std::endl;
+            std::vector<std::string> results;
+
+            auto start = Clock::now();
+            RoutePlanner::Graph graph = generate(family, size, options.seed);
+            results.push_back(stage("generate", elapsedMs(start)).str());
+
+            start = Clock::now();
+            RoutePlanner::CompactGraph compact = graph.freeze();
+            results.push_back(stage("freeze", elapsedMs(start)).str());
+
+            if (options.loader) benchLoader(graph, compact, results);
+
+            // Same seeded workload for every engine
+            std::mt19937 rng(options.seed);
+            std::vector<std::pair<int, int>> pairs(options.queries);
+            for (auto& pair : pairs) {
+                pair = {compact.idOf(rng() % compact.numNodes()), compact.idOf(rng() % compact.numNodes())};
+            }
+
+            RoutePlanner::SearchContext forward, backward;
+            auto runOn = [&](const RoutePlanner::CompactGraph& layout, const std::string& engine,
+                             const RoutePlanner::RouteOptions& routeOptions) {
+                counters.start();
+                JsonObject json = runQueries(engine, pairs, [&](int s, int t, size_t& settled) {
+                    auto result = routeOptions.bidirectional
+                        ? RoutePlanner::Router::computePath(layout, s, t, routeOptions, forward, backward)
+                        : RoutePlanner::Router::computePath(layout, s, t, routeOptions, forward);
+                    settled = forward.numSettled() + (routeOptions.bidirectional ? backward.numSettled() : 0);
+                    return result;
+                });
+                counters.stop(json);
+                results.push_back(json.str());
+            };
+            auto runRouter = [&](const std::string& engine, const RoutePlanner::RouteOptions& routeOptions) {
+                runOn(compact, engine, routeOptions);
+            };
+
+            RoutePlanner::RouteOptions dijkstra;
+            dijkstra.heuristic = RoutePlanner::HeuristicType::Zero;
+            runRouter("dijkstra", dijkstra);
+
+            // Same search on each frontier policy
+            dijkstra.queue = RoutePlanner::QueueType::FourAryHeap;
+            runRouter("dijkstra_4ary", dijkstra);
+            dijkstra.queue = RoutePlanner::QueueType::RadixHeap;
+            runRouter("dijkstra_radix", dijkstra);
+
+            RoutePlanner::RouteOptions astar;
+            runRouter("astar", astar);
+
+            // Compile-time specialized: distance only, no parents, no options to branch on
+            using LeanDijkstra = RoutePlanner::BasicRouter<RoutePlanner::CompactGraph, RoutePlanner::ZeroBound, double,
+                                                           RoutePlanner::DistanceOnly>;
+            using LeanAStar = RoutePlanner::BasicRouter<RoutePlanner::CompactGraph, RoutePlanner::EuclideanBound,
+                                                        double, RoutePlanner::DistanceOnly>;
+            auto runDistanceOnly = [&](const std::string& engine, auto query) {
+                results.push_back(runQueries(engine, pairs, [&](int s, int t, size_t& settled) {
+                    const double cost = query(s, t);
+                    settled = forward.numSettled();
+                    return RoutePlanner::RouteResult{ {}, std::isinf(cost) ? 0.0 : cost, !std::isinf(cost) };
+                }).str());
+            };
+            runDistanceOnly("dijkstra_distance_only",
+                            [&](int s, int t) { return LeanDijkstra::computePath(compact, s, t, forward); });
+            runDistanceOnly("astar_distance_only",
+                            [&](int s, int t) { return LeanAStar::computePath(compact, s, t, forward); });
+            astar.queue = RoutePlanner::QueueType::FourAryHeap;
+            runRouter("astar_4ary", astar);
+
+            RoutePlanner::RouteOptions bidirectional;
+            bidirectional.bidirectional = true;
+            runRouter("bidirectional_astar", bidirectional);
+
+            // Three alternatives per query, distanceSum covers the first (shortest) one
+            results.push_back(runQueries("yen_k3", pairs, [&](int s, int t, size_t& settled) {
+                auto routes = RoutePlanner::Router::kShortestPaths(compact, s, t, 3, forward, backward);
+                settled = backward.numSettled(); // Shared reverse tree only, spur searches not counted
+                return routes.empty() ? RoutePlanner::RouteResult{{}, 0.0, false} : routes.front();
+            }).str());
+
+            start = Clock::now();
+            auto landmarks = RoutePlanner::Landmarks::select(compact, options.landmarks);
+            results.push_back(stage("alt_preprocess", elapsedMs(start)).str());
+            RoutePlanner::RouteOptions alt;
+            alt.heuristic = RoutePlanner::HeuristicType::Landmark;
+            alt.landmarks = &landmarks;
+            runRouter("alt", alt);
+
+            if (compact.numNodes() <= options.chMaxNodes) {
+                start = Clock::now();
+                auto ch = RoutePlanner::ContractionHierarchy::build(compact);
+                results.push_back(stage("ch_preprocess", elapsedMs(start)).str());
+                results.push_back(runQueries("ch", pairs, [&](int s, int t, size_t& settled) {
+                    auto result = ch.query(s, t, forward, backward);
+                    settled = forward.numSettled() + backward.numSettled();
+                    return result;
+                }).str());
+
+                // Hub labels on the CH order; queries settle nothing, only merge two labels
+                start = Clock::now();
+                auto hubLabels = RoutePlanner::HubLabels::build(compact, ch);
+                JsonObject hlStage = stage("hl_preprocess", elapsedMs(start));
+                hlStage.add("labelEntries", hubLabels.numEntries()).add("bytes", hubLabels.bytesUsed());
+                results.push_back(hlStage.str());
+                results.push_back(runQueries("hub_labels", pairs, [&](int s, int t, size_t& settled) {
+                    settled = 0;
+                    return hubLabels.query(s, t);
+                }).str());
+            }
+
+            // Same workload on each reordered layout; queries use IDs, so 'pairs' still applies
+            // and distanceSum must match the ID-ordered runs above
+            for (const auto& name : options.orders) {
+                auto order = std::find_if(knownOrders.begin(), knownOrders.end(),
+                                          [&](const auto& entry) { return entry.first == name; })->second;
+                start = Clock::now();
+                RoutePlanner::CompactGraph reordered = RoutePlanner::NodeOrdering::apply(compact, order);
+                results.push_back(stage("reorder_" + name, elapsedMs(start)).str());
+
+                RoutePlanner::RouteOptions plain;
+                plain.heuristic = RoutePlanner::HeuristicType::Zero;
+                runOn(reordered, "dijkstra@" + name, plain);
+                runOn(reordered, "astar@" + name, RoutePlanner::RouteOptions{});
+            }
+
+            // Compressed edge store, Hilbert order keeps the neighbour deltas small
+            start = Clock::now();
+            RoutePlanner::CompressedGraph compressed(
+                RoutePlanner::NodeOrdering::apply(compact, RoutePlanner::NodeOrder::Hilbert));
+            JsonObject compressStage = stage("compress", elapsedMs(start));
+            compressStage.add("edgeBytes", compressed.edgeBytes())
+                .add("csrEdgeBytes", compact.numEdges() * 2 * (sizeof(int) + sizeof(double)))
+                .add("resolution", compressed.resolution());
+            results.push_back(compressStage.str());
+            auto runCompressed = [&](const std::string& engine, const RoutePlanner::RouteOptions& routeOptions) {
+                counters.start();
+                JsonObject json = runQueries(engine, pairs, [&](int s, int t, size_t& settled) {
+                    auto result = RoutePlanner::Router::computePath(compressed, s, t, routeOptions, forward);
+                    settled = forward.numSettled();
+                    return result;
+                });
+                counters.stop(json);
+                results.push_back(json.str());
+            };
+            RoutePlanner::RouteOptions plain;
+            plain.heuristic = RoutePlanner::HeuristicType::Zero;
+            runCompressed("dijkstra_compressed", plain);
+            runCompressed("astar_compressed", RoutePlanner::RouteOptions{});
+            results.push_back(runQueries("dijkstra_compressed_codes", pairs, [&](int s, int t, size_t& settled) {
+                auto result = RoutePlanner::BasicRouter<RoutePlanner::CompressedGraph, RoutePlanner::ZeroBound,
+                                                        uint32_t>::computePath(compressed, s, t, forward);
+                settled = forward.numSettled();
+                return result;
+            }).str());
+
+            // Many-to-many: one square matrix over the first query endpoints
+            size_t side = std::min<size_t>(64, pairs.size());
+            std::vector<int> sources, targets;
+            for (size_t i = 0; i < side; ++i) {
+                sources.push_back(pairs[i].first);
+                targets.push_back(pairs[i].second);
+            }
+            start = Clock::now();
+            RoutePlanner::Router::distanceMatrix(compact, sources, targets);
+            results.push_back(stage("matrix_" + std::to_string(side) + "x" + std::to_string(side), elapsedMs(start)).str());
+
+            JsonObject graphInfo;
+            graphInfo.add("family", family)
+                .add("requestedNodes", size)
+                .add("nodes", compact.numNodes())
+                .add("edges", compact.numEdges())
+                .add("seed", static_cast<size_t>(options.seed));
+
+            std::string list;
+            for (const auto& result : results) list += (list.empty() ? "\n      " : ",\n      ") + result;
+            runs.push_back("{\"graph\": " + graphInfo.str() + ",\n    \"results\": [" + list + "\n    ]}");
+        }
+    }
+
+    // Distance kernel A* picked on this machine, timings differ between them
+    const char* kernel = RoutePlanner::DistanceKernels::active() == RoutePlanner::KernelIsa::Avx2 ? "avx2" : "scalar";
+    std::string document = std::string("{\"benchmark\": \"RoutePlanner\", \"kernel\": \"") + kernel + "\", \"runs\": [";
+    for (size_t i = 0; i < runs.size(); ++i) document += (i == 0 ? "\n  " : ",\n  ") + runs[i];
+    document += "\n]}\n";
+
+    if (options.output.empty()) {
+        std::cout << document;
+    } else {
+        std::ofstream file(options.output);
+        file << document;
+        if (!file) {
+            std::cerr << "Error: Could not write " << options.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
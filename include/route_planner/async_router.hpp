@@ -0,0 +1,105 @@
+#ifndef ASYNC_ROUTER_HPP
+#define ASYNC_ROUTER_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/router.hpp"
+#include "route_planner/search_context.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace RoutePlanner {
+    // One query submitted to an AsyncRouter. Cheap to copy, copies share the query
+    class RouteHandle {
+    public:
+        RouteHandle() = default;
+
+        // False for a default-constructed handle
+        bool valid() const { return state != nullptr; }
+
+        // Finished, cancelled or failed: get() won't block
+        bool ready() const;
+
+        // Block until ready
+        void wait() const;
+
+        // The route; success == false if none exists or the query was cancelled
+        // Rethrows what computePath threw (e.g. std::invalid_argument for bad landmarks)
+        RouteResult get() const;
+
+        // Ask the search to stop; it notices within a few hundred expanded nodes
+        void cancel();
+        bool cancelled() const;
+
+        // External IDs expanded since the last call, oldest first, for drawing the frontier
+        std::vector<int> takeProgress();
+
+    private:
+        friend class AsyncRouter;
+
+        struct State {
+            std::atomic<bool> cancelFlag{false};
+            mutable std::mutex mutex;
+            mutable std::condition_variable finished;
+            bool done = false;
+            RouteResult result = { {}, 0.0, false };
+            std::exception_ptr error;
+            std::vector<int> progress;
+        };
+
+        explicit RouteHandle(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+        std::shared_ptr<State> state;
+    };
+
+    // Router::computePath on a worker thread, so a UI keeps drawing while it runs
+    // Newest query wins: submit() cancels the query still running or waiting, so
+    // a burst of clicks only pays for the last one
+    // 'graph' must outlive the router and not change while it is in use
+    class AsyncRouter {
+    public:
+        explicit AsyncRouter(const CompactGraph& graph);
+
+        // Cancels whatever is in flight and joins the worker
+        ~AsyncRouter();
+
+        AsyncRouter(const AsyncRouter&) = delete;
+        AsyncRouter& operator=(const AsyncRouter&) = delete;
+
+        // Queue a query, superseding the previous one
+        // options.cancel is replaced by the handle's own flag; options.onProgress,
+        // if set, still runs (on the worker) alongside the handle's progress buffer
+        RouteHandle submit(int startId, int endId, const RouteOptions& options = RouteOptions{});
+
+        // Cancel the latest query, if any
+        void cancel();
+
+    private:
+        struct Job {
+            int startId;
+            int endId;
+            RouteOptions options;
+            std::shared_ptr<RouteHandle::State> state;
+        };
+
+        void workerLoop();
+        static void finish(RouteHandle::State& state, RouteResult result, std::exception_ptr error = nullptr);
+
+        const CompactGraph& graph;
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::optional<Job> pending; // At most one: a newer submit replaces it
+        std::shared_ptr<RouteHandle::State> latest; // Cancelled by the next submit
+        bool stopping = false;
+        SearchContext forward; // Only touched by the worker
+        SearchContext backward;
+        std::thread worker; // Last, starts once everything above exists
+    };
+}
+
+#endif
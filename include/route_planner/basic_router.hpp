@@ -0,0 +1,65 @@
+#ifndef BASIC_ROUTER_HPP
+#define BASIC_ROUTER_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/compressed_graph.hpp"
+#include "route_planner/router.hpp"
+#include "route_planner/search_context.hpp"
+#include <cstdint>
+#include <type_traits>
+
+namespace RoutePlanner {
+    // Heuristic policies
+    struct ZeroBound {}; // Plain Dijkstra, no per-node bound at all
+    struct EuclideanBound {}; // Straight-line A*, as HeuristicType::Euclidean
+
+    // Output policies
+    struct WithPath {}; // RouteResult with the node sequence
+    struct DistanceOnly {}; // Just the cost; parents are never written
+
+    // Router::computePath with every engine choice fixed at compile time, for
+    // callers that always ask the same kind of query in a hot loop
+    // Each combination compiles to its own search with the unused work left out:
+    // no heuristic call under ZeroBound, no parent writes or backtracking under
+    // DistanceOnly, and with Weight = uint32_t on a CompressedGraph no per-edge
+    // decode: the stored fixed-point codes go straight into the distance sums,
+    // which are scaled by resolution() once at the end
+    // Distances and queue keys are still doubles in that case (sums of codes stay
+    // exact below 2^53); only the decode multiply and infinity check are saved
+    // Always a lazy binary heap, no stats, no cancel/progress; use Router for those
+    //
+    // Defined in router.cpp, instantiated there for the combinations listed below
+    template <typename GraphType, typename Heuristic = EuclideanBound, typename Weight = double,
+              typename Output = WithPath>
+    class BasicRouter {
+        static_assert(std::is_same_v<GraphType, CompactGraph> || std::is_same_v<GraphType, CompressedGraph>,
+                      "BasicRouter runs on CompactGraph or CompressedGraph");
+        static_assert(std::is_same_v<Heuristic, ZeroBound> || std::is_same_v<Heuristic, EuclideanBound>,
+                      "Heuristic must be ZeroBound or EuclideanBound");
+        static_assert(std::is_same_v<Weight, double>
+                          || (std::is_same_v<Weight, uint32_t> && std::is_same_v<GraphType, CompressedGraph>),
+                      "Weight is double, or uint32_t for the codes of a CompressedGraph");
+        static_assert(std::is_same_v<Output, WithPath> || std::is_same_v<Output, DistanceOnly>,
+                      "Output must be WithPath or DistanceOnly");
+
+    public:
+        // DistanceOnly gives the cost alone, infinity if unreachable or an ID is unknown
+        using Result = std::conditional_t<std::is_same_v<Output, DistanceOnly>, double, RouteResult>;
+
+        // IDs are external node IDs; uses a thread-local SearchContext
+        static Result computePath(const GraphType& graph, int startId, int endId);
+        static Result computePath(const GraphType& graph, int startId, int endId, SearchContext& context);
+    };
+
+    // Explicitly instantiated in router.cpp
+    extern template class BasicRouter<CompactGraph, ZeroBound, double, WithPath>;
+    extern template class BasicRouter<CompactGraph, ZeroBound, double, DistanceOnly>;
+    extern template class BasicRouter<CompactGraph, EuclideanBound, double, WithPath>;
+    extern template class BasicRouter<CompactGraph, EuclideanBound, double, DistanceOnly>;
+    extern template class BasicRouter<CompressedGraph, ZeroBound, uint32_t, WithPath>;
+    extern template class BasicRouter<CompressedGraph, ZeroBound, uint32_t, DistanceOnly>;
+    extern template class BasicRouter<CompressedGraph, EuclideanBound, uint32_t, WithPath>;
+    extern template class BasicRouter<CompressedGraph, EuclideanBound, uint32_t, DistanceOnly>;
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef COMPACT_GRAPH_HPP
+#define COMPACT_GRAPH_HPP
+
+#include "route_planner/graph.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+
+namespace RoutePlanner {
+    // New cost for the road 'from' -> 'to' (external IDs), applies to parallel edges too
+    struct WeightUpdate {
+        int from;
+        int to;
+        double weight;
+    };
+
+    // Immutable, cache-friendly copy of a Graph for the routing hot path
+    // External node IDs are remapped to dense indices [0, numNodes()), in ID order
+    // unless the graph was permuted() for locality (see node_order.hpp)
+    // Edges are stored in compressed-sparse-row (CSR) form:
+    // out-edges of node i live in [edgeBegin(i), edgeEnd(i)) of the target/weight arrays
+    // A reverse CSR (in-edges) is kept too, for backward searches on one-way roads
+    // The arrays can also be memory-mapped straight from a binary snapshot (see save/load)
+    class CompactGraph {
+    public:
+        CompactGraph();
+
+        // Snapshot 'graph'. Later changes to 'graph' are not reflected here
+        // Edges pointing at unknown node IDs are dropped
+        explicit CompactGraph(const Graph& graph);
+
+        size_t numNodes() const { return nodeCount; }
+        size_t numEdges() const { return edgeCount; }
+
+        // Graph::getVersion() at freeze time; loaded snapshots get a fresh one
+        uint64_t version() const { return graphVersion; }
+
+        // Which dense index holds which node: 0 in ID order, else a hash of the
+        // permuted ID array. Data indexed by dense index (landmarks) is only valid
+        // on graphs with the same layout(); kept across save/load and withWeights()
+        uint64_t layout() const { return graphLayout; }
+
+        // Dense index of an external node ID, -1 if not found
+        int indexOf(int id) const;
+
+        // External node ID of a dense index
+        int idOf(int index) const { return ids[index]; }
+
+        // Out-edge range of a dense index
+        uint32_t edgeBegin(int index) const { return offsets[index]; }
+        uint32_t edgeEnd(int index) const { return offsets[index + 1]; }
+        uint32_t degree(int index) const { return offsets[index + 1] - offsets[index]; }
+
+        // Dense index of edge target, and its weight
+        int target(uint32_t edge) const { return targets[edge]; }
+        double weight(uint32_t edge) const { return weights[edge]; }
+
+        // In-edge range of a dense index, indices into the source/inWeight arrays
+        uint32_t inEdgeBegin(int index) const { return inOffsets[index]; }
+        uint32_t inEdgeEnd(int index) const { return inOffsets[index + 1]; }
+
+        // Dense index of in-edge source, and its weight
+        int source(uint32_t inEdge) const { return sources[inEdge]; }
+        double inWeight(uint32_t inEdge) const { return inWeights[inEdge]; }
+
+        // Coordinates, stored as separate arrays (structure of arrays)
+        double x(int index) const { return xs[index]; }
+        double y(int index) const { return ys[index]; }
+
+        // Names are interned in a single buffer
+        std::string_view name(int index) const;
+
+        // Raw arrays for tight loops
+        const uint32_t* offsetData() const { return offsets; }
+        const int* targetData() const { return targets; }
+        const double* weightData() const { return weights; }
+        const uint32_t* inOffsetData() const { return inOffsets; }
+        const int* sourceData() const { return sources; }
+        const double* inWeightData() const { return inWeights; }
+        const double* xData() const { return xs; }
+        const double* yData() const { return ys; }
+
+        // Copy with old node 'order[i]' moved to dense index i, edges renumbered to match
+        // External IDs stay the same, so query results don't change, only memory layout
+        // 'order' must be a permutation of [0, numNodes())
+        CompactGraph permuted(const std::vector<int>& order) const;
+
+        // Copy with 'updates' applied and a new version(); shares every array
+        // but the two weight arrays with this graph, so a batch costs O(edges + updates)
+        // Updates naming no existing edge are skipped, 'applied' counts the others
+        // Throws std::invalid_argument on a negative or NaN weight
+        CompactGraph withWeights(const std::vector<WeightUpdate>& updates, size_t* applied = nullptr) const;
+
+        // Versioned, checksummed binary snapshot, written once per map build
+        // load() memory-maps the file, so startup skips CSV parsing and processes
+        // on one host share the same page-cache pages
+        // 'verify' re-hashes the whole file; skip it for trusted files on huge maps
+        // Return true if successful, false otherwise
+        bool save(const std::string& filepath) const;
+        static bool load(const std::string& filepath, CompactGraph& graph, bool verify = true);
+
+    private:
+        // Heap arrays filled by the Graph constructor
+        struct Buffers;
+
+        // Point the views below at 'buffers', which becomes the storage
+        void adopt(std::shared_ptr<Buffers> buffers);
+
+        size_t nodeCount = 0;
+        size_t edgeCount = 0;
+        uint64_t graphVersion;
+        uint64_t graphLayout = 0;
+
+        // Views into 'storage'
+        const int* ids = nullptr; // Dense index -> external ID, ascending unless permuted
+        const int* idOrder = nullptr; // Dense indices by ascending ID, null when 'ids' is sorted
+        const uint32_t* offsets = nullptr; // numNodes() + 1 entries
+        const int* targets = nullptr; // Dense target index per edge
+        const double* weights = nullptr; // Weight per edge
+        const uint32_t* inOffsets = nullptr; // Reverse CSR, numNodes() + 1 entries
+        const int* sources = nullptr; // Dense source index per in-edge
+        const double* inWeights = nullptr; // Weight per in-edge
+        const double* xs = nullptr;
+        const double* ys = nullptr;
+        const uint32_t* nameOffsets = nullptr; // numNodes() + 1 entries into nameData
+        const char* nameData = nullptr;
+
+        // Owns the arrays: heap Buffers or a MappedFile. Copies share it
+        std::shared_ptr<const void> storage;
+
+        // Owns weights/inWeights instead of 'storage' after withWeights(), else null
+        std::shared_ptr<const void> weightStorage;
+    };
+}
+
+#endif
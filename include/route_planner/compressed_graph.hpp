@@ -0,0 +1,126 @@
+#ifndef COMPRESSED_GRAPH_HPP
+#define COMPRESSED_GRAPH_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace RoutePlanner {
+    // Smaller read-only copy of a CompactGraph, for maps whose edge arrays don't fit in RAM
+    // Same dense indices and external IDs as the source, so results match up
+    //
+    // Each node keeps one byte stream holding its out- and in-edges together,
+    // sorted by neighbour. Per entry:
+    //   varint: zigzag(neighbour - previous neighbour) << 2 | direction
+    //   4 bytes: weight in units of resolution()
+    // The first neighbour is relative to the node itself, so a locality order
+    // (see node_order.hpp) keeps most deltas to one byte. An edge whose reverse
+    // has the same weight, as every two-way road loaded by MapLoader does, is
+    // stored once per endpoint with direction "both" instead of four times
+    // (out and in, at either end) as in CompactGraph
+    //
+    // Weights are rounded up to a multiple of resolution(): a decoded weight is
+    // never below the original and at most resolution() above it, so a path of
+    // k edges costs at most k * resolution() more. Rounding up keeps the Euclidean
+    // and ALT heuristics admissible. Infinite weights stay infinite
+    class CompressedGraph {
+    public:
+        CompressedGraph() = default;
+
+        // 'resolution' 0 picks the finest one that still fits the largest finite weight
+        // Throws std::invalid_argument on a negative or NaN weight, a negative
+        // resolution, or one too fine for the largest weight
+        // Throws std::length_error if the edge streams pass 4 GiB
+        explicit CompressedGraph(const CompactGraph& graph, double resolution = 0.0);
+
+        size_t numNodes() const { return ids.size(); }
+        size_t numEdges() const { return edgeCount; } // Directed, as in the source
+
+        uint64_t version() const { return graphVersion; } // The source's
+        uint64_t layout() const { return graphLayout; } // The source's, see CompactGraph::layout()
+
+        // Weight unit, and so the largest rounding error per edge
+        double resolution() const { return unit; }
+
+        // Dense index of an external node ID, -1 if not found
+        int indexOf(int id) const;
+        int idOf(int index) const { return ids[index]; }
+
+        double x(int index) const { return xs[index]; }
+        double y(int index) const { return ys[index]; }
+        const double* xData() const { return xs.data(); }
+        const double* yData() const { return ys.data(); }
+
+        // Call visit(target, weight) for each out-edge of a dense index, decoding as it goes
+        template <typename Visit>
+        void forEachOutEdge(int index, Visit&& visit) const { forEachEdge<OUT>(index, visit); }
+
+        // Call visit(source, weight) for each in-edge
+        template <typename Visit>
+        void forEachInEdge(int index, Visit&& visit) const { forEachEdge<IN>(index, visit); }
+
+        // Call visit(target, code) with the weight still in units of resolution(), skipping
+        // infinite edges, for searches that add codes and scale once at the end
+        template <typename Visit>
+        void forEachOutCode(int index, Visit&& visit) const { forEachEdge<OUT, true>(index, visit); }
+
+        // Heap memory held, node arrays included
+        size_t bytesUsed() const;
+
+        // Edge stream bytes alone
+        size_t edgeBytes() const { return data.size(); }
+
+    private:
+        // Direction bits of an entry
+        static constexpr uint32_t OUT = 1;
+        static constexpr uint32_t IN = 2;
+        static constexpr uint32_t INFINITE_WEIGHT = std::numeric_limits<uint32_t>::max();
+
+        template <uint32_t Direction, bool Codes = false, typename Visit>
+        void forEachEdge(int index, Visit& visit) const {
+            const uint8_t* p = data.data() + offsets[index];
+            const uint8_t* end = data.data() + offsets[index + 1];
+            int64_t neighbour = index;
+            while (p < end) {
+                uint64_t header = *p++;
+                if (header & 0x80) { // Multi-byte varint, rare with a locality order
+                    header &= 0x7f;
+                    int shift = 7;
+                    uint8_t byte;
+                    do {
+                        byte = *p++;
+                        header |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                        shift += 7;
+                    } while (byte & 0x80);
+                }
+                uint32_t code;
+                std::memcpy(&code, p, sizeof(code));
+                p += sizeof(code);
+
+                const uint64_t zigzag = header >> 2;
+                neighbour += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+                if constexpr (Codes) {
+                    if ((header & Direction) && code != INFINITE_WEIGHT) visit(static_cast<int>(neighbour), code);
+                } else if (header & Direction) {
+                    visit(static_cast<int>(neighbour),
+                          code == INFINITE_WEIGHT ? std::numeric_limits<double>::infinity() : code * unit);
+                }
+            }
+        }
+
+        std::vector<int> ids; // Dense index -> external ID, as in the source
+        std::vector<int> idOrder; // Dense indices by ascending ID, empty when 'ids' is sorted
+        std::vector<double> xs;
+        std::vector<double> ys;
+        std::vector<uint32_t> offsets; // numNodes() + 1 byte offsets into 'data'
+        std::vector<uint8_t> data; // Edge streams, node after node
+        size_t edgeCount = 0;
+        double unit = 1.0;
+        uint64_t graphVersion = 0;
+        uint64_t graphLayout = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef CONTRACTION_HIERARCHY_HPP
+#define CONTRACTION_HIERARCHY_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/search_context.hpp"
+#include "route_planner/router.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace RoutePlanner {
+    // Contraction Hierarchy (CH) speed-up technique
+    // Preprocessing contracts nodes one by one in order of importance and adds
+    // shortcut edges where no witness path exists. Queries then run a
+    // bidirectional Dijkstra that only climbs towards more important nodes
+    class ContractionHierarchy {
+    public:
+        ContractionHierarchy() = default;
+
+        // Offline preprocessing, can take a while on big maps
+        static ContractionHierarchy build(const CompactGraph& graph);
+
+        // Point-to-point query on external IDs, shortcuts unpacked into original nodes
+        // Uses thread-local workspaces
+        // 'collectStats' fills RouteResult::stats, recorded under "ch"
+        RouteResult query(int startId, int endId, bool collectStats = false) const;
+
+        // Caller-owned workspaces, one per search direction
+        RouteResult query(int startId, int endId, SearchContext& forward, SearchContext& backward,
+                          bool collectStats = false) const;
+
+        // Binary file, so preprocessing runs once per map build
+        // Return true if successful, false otherwise
+        bool save(const std::string& filepath) const;
+        static bool load(const std::string& filepath, ContractionHierarchy& ch);
+
+        size_t numNodes() const { return ids.size(); }
+        size_t numShortcuts() const { return shortcutCount; }
+
+        // Contraction order of an external ID (0 = contracted first), -1 if not found
+        int rankOf(int id) const;
+
+    private:
+        // Upward edge in the hierarchy
+        struct Arc {
+            int node; // Other endpoint (dense index)
+            int middle; // Contracted node this shortcut bypasses, -1 for original edges
+            double weight;
+        };
+
+        int indexOf(int id) const;
+
+        // Fill idOrder if 'ids' came from a permuted graph
+        void indexIds();
+
+        // Query body, 'recorder' is NoStats or StatsRecorder (see search_stats.hpp)
+        template <typename Recorder>
+        RouteResult search(int start, int end, SearchContext& forward, SearchContext& backward, Recorder& recorder) const;
+
+        const Arc* findArc(int from, int to) const;
+        void unpack(int from, int to, std::vector<int>& out) const;
+
+        std::vector<int> ids; // Dense index -> external ID, same order as CompactGraph
+        std::vector<int> idOrder; // Dense indices by ascending ID, empty when 'ids' is sorted
+        std::vector<int> ranks; // Dense index -> contraction order
+
+        // Forward search graph: arcs u -> v with rank(v) > rank(u), stored at u
+        std::vector<uint32_t> forwardOffsets;
+        std::vector<Arc> forwardArcs;
+
+        // Backward search graph: arcs u -> v with rank(u) > rank(v), stored at v
+        std::vector<uint32_t> backwardOffsets;
+        std::vector<Arc> backwardArcs;
+
+        uint64_t shortcutCount = 0;
+    };
+}
+
+#endif
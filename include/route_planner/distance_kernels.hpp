@@ -0,0 +1,38 @@
+#ifndef DISTANCE_KERNELS_HPP
+#define DISTANCE_KERNELS_HPP
+
+#include <cstddef>
+
+namespace RoutePlanner {
+    // Instruction sets the batch kernels are built for
+    enum class KernelIsa {
+        Scalar,
+        Avx2 // x86-64 with GCC/Clang only, picked at runtime if the CPU has it
+    };
+
+    // Straight-line distances from a block of nodes to one point, over SoA coordinate arrays
+    // Used by A* to evaluate the heuristic for a whole neighbour block at once
+    // Every ISA gives bit-identical results (no FMA, sqrt is correctly rounded),
+    // so switching kernels never changes a route
+    class DistanceKernels {
+    public:
+        // Best ISA this CPU supports, detected once
+        static KernelIsa active();
+
+        // out[i] = distance from (xs[nodes[i]], ys[nodes[i]]) to (x, y), for i < count
+        static void euclidean(const double* xs, const double* ys, const int* nodes, size_t count, double x, double y,
+                              double* out);
+
+        // Same without the sqrt, enough for comparing or thresholding distances
+        static void squaredEuclidean(const double* xs, const double* ys, const int* nodes, size_t count, double x,
+                                     double y, double* out);
+
+        // Explicit ISA, for tests and benchmarks; one the CPU lacks falls back to Scalar
+        static void euclidean(KernelIsa isa, const double* xs, const double* ys, const int* nodes, size_t count,
+                              double x, double y, double* out);
+        static void squaredEuclidean(KernelIsa isa, const double* xs, const double* ys, const int* nodes, size_t count,
+                                     double x, double y, double* out);
+    };
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef GENERATORS_HPP
+#define GENERATORS_HPP
+
+#include "route_planner/graph.hpp"
+#include <cstddef>
+
+namespace RoutePlanner {
+    // Synthetic maps for benchmarks and tests
+    // Output depends only on the arguments and seed (no std:: distributions,
+    // whose results differ between standard libraries)
+    // Nodes get IDs 1..N and names "n<ID>". Every edge weighs at least the
+    // straight-line distance between its ends, so the Euclidean A* heuristic stays exact
+    class Generators {
+    public:
+        // width x height lattice of two-way roads, unit spacing, weights jittered up to +50%
+        static Graph grid(size_t width, size_t height, unsigned seed = 1);
+
+        // Uniform points at density 1 in a square, two-way roads between all pairs
+        // closer than the radius that gives 'averageDegree' neighbours on average
+        static Graph randomGeometric(size_t numNodes, double averageDegree, unsigned seed = 1);
+
+        // Barabasi-Albert preferential attachment: each new node links to
+        // 'edgesPerNode' existing nodes with probability proportional to degree
+        // Few hubs, many leaves; coordinates are uniform and unrelated to structure
+        static Graph scaleFree(size_t numNodes, size_t edgesPerNode, unsigned seed = 1);
+    };
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <cstdint>
 
 namespace RoutePlanner {
     // Rep directed connection from one node to another
@@ -20,15 +21,20 @@ namespace RoutePlanner {
         std::vector<Edge> neighbors; // Adjacency list
     };
 
+    class CompactGraph;
+
     class Graph {
     public:
         // Default constructor  
-        Graph() = default;
+        Graph();
 
         // Add Node to the map
         // 'const std::string& name' pass by reference to avoid copying, const to prevent modification
         void addNode(int id, const std::string& name, double x, double y);
 
+        // Pre-size the node table before bulk loading
+        void reserve(size_t nodeCount);
+
         // Create connection between two nodes
         // Call twice for bidirectional road
         void addEdge(int u, int v, double distance);
@@ -36,16 +42,32 @@ namespace RoutePlanner {
         // Return pointer to node by ID, nullptr if not found
         const Node* getNode(int id) const;
 
-        // Find Node by Name
+        // Find Node by Name, O(1) via a name -> IDs index
+        // Duplicate names resolve to the smallest ID, -1 if not found
         int findIdByName(const std::string& name) const;
 
         // Return entire map
         // const at end ensures method does not modify class members
         const std::unordered_map<int, Node>& getAllNodes() const;
+
+        // Build immutable CSR copy for fast routing (see compact_graph.hpp)
+        CompactGraph freeze() const;
+
+        // Changes on every addNode/addEdge, unique across all graphs in the process
+        // Caches key on it (see route_cache.hpp), so a mutated map never matches old entries
+        uint64_t getVersion() const { return version; }
+
+        // Fresh process-wide version number
+        static uint64_t nextVersion();
     private:
         // Hash map provides O(1) lookup
         // Key: Node ID, Value: Node struct
         std::unordered_map<int, Node> nodes;
+
+        // Key: Node name, Value: IDs with that name, sorted ascending
+        std::unordered_map<std::string, std::vector<int>> idsByName;
+
+        uint64_t version;
     };
 };
 
@@ -0,0 +1,83 @@
+#ifndef HUB_LABELS_HPP
+#define HUB_LABELS_HPP
+
+#include "route_planner/graph.hpp"
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/contraction_hierarchy.hpp"
+#include "route_planner/router.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RoutePlanner {
+    // Hub labeling: every node stores (hub, distance) pairs to and from a few
+    // important nodes, chosen so that any shortest s -> t path passes a hub in
+    // both out-label(s) and in-label(t). A distance query is then one merge of
+    // two sorted arrays, no search at all
+    // Built with pruned landmark labeling (Akiba et al.), hubs taken in contraction
+    // hierarchy order, which keeps labels small on road networks
+    // Labels live in CSR arrays split by field (hubs / distances / parents), each
+    // ending in a sentinel hub, so the merge loop is branch-light and has no bounds checks
+    class HubLabels {
+    public:
+        HubLabels() = default;
+
+        // Offline preprocessing: builds a ContractionHierarchy for the hub order first
+        static HubLabels build(const CompactGraph& graph);
+        static HubLabels build(const Graph& graph);
+
+        // Reuse the order of a hierarchy already built on the same graph
+        // Throws std::invalid_argument if it doesn't cover every node of 'graph'
+        static HubLabels build(const CompactGraph& graph, const ContractionHierarchy& hierarchy);
+
+        // Shortest distance on external IDs, infinity if unreachable or unknown
+        double distance(int startId, int endId) const;
+
+        // Same with the path, walked through the parent stored with each label entry
+        RouteResult query(int startId, int endId) const;
+
+        // Binary file, so preprocessing runs once per map build
+        // Return true if successful, false otherwise
+        bool save(const std::string& filepath) const;
+        static bool load(const std::string& filepath, HubLabels& labels);
+
+        size_t numNodes() const { return ids.size(); }
+
+        // Label entries over all nodes, both directions, sentinels excluded
+        size_t numEntries() const;
+
+        // Heap memory held
+        size_t bytesUsed() const;
+
+    private:
+        // One direction of labels for all nodes
+        struct Labels {
+            std::vector<uint32_t> offsets; // numNodes() + 1, each label ends with a SENTINEL entry
+            std::vector<uint32_t> hubs; // Hub order, ascending within a label
+            std::vector<double> dists;
+            // Next node towards the hub (out-labels) or previous node from it (in-labels), -1 at the hub
+            std::vector<int> parents;
+        };
+
+        static constexpr uint32_t SENTINEL = UINT32_MAX;
+
+        int indexOf(int id) const;
+
+        // Fill idOrder if 'ids' came from a permuted graph
+        void indexIds();
+
+        // Merge of out-label(s) and in-label(t); 'hub' gets the hub order of the best meeting point
+        double intersect(int s, int t, uint32_t& hub) const;
+
+        // Entry for 'hub' in one label, binary search
+        uint32_t findEntry(const Labels& labels, int node, uint32_t hub) const;
+
+        std::vector<int> ids; // Dense index -> external ID, same order as CompactGraph
+        std::vector<int> idOrder; // Dense indices by ascending ID, empty when 'ids' is sorted
+        std::vector<int> hubNodes; // Hub order -> dense index
+        Labels out; // Distances from each node to its hubs
+        Labels in; // Distances from hubs to each node
+    };
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include <vector>
+#include <cstdint>
+
+namespace RoutePlanner {
+    // How landmarks are picked
+    enum class LandmarkStrategy {
+        Farthest, // Repeatedly take the node farthest from the landmarks so far
+        Avoid // Goldberg-Harrelson "avoid": grow into regions the current set covers badly
+    };
+
+    // ALT (A*, Landmarks, Triangle inequality) preprocessing
+    // Stores exact distances to and from a few landmark nodes. By the triangle
+    // inequality, d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L),
+    // which gives a tight, consistent A* heuristic on any weights
+    class Landmarks {
+    public:
+        Landmarks() = default;
+
+        // Pick 'count' landmarks and run one forward and one backward Dijkstra per landmark
+        static Landmarks select(const CompactGraph& graph, size_t count,
+                                LandmarkStrategy strategy = LandmarkStrategy::Avoid, unsigned seed = 1);
+
+        size_t size() const { return landmarks.size(); }
+        size_t numNodes() const { return nodeCount; }
+
+        // CompactGraph::layout() and version() of the graph they were selected on
+        // Routing on another layout or another set of weights throws, the bounds would be wrong
+        uint64_t layout() const { return graphLayout; }
+        uint64_t version() const { return graphVersion; }
+
+        // Dense index of the i-th landmark
+        int landmark(size_t i) const { return landmarks[i]; }
+
+        // Lower bound on the shortest distance from 'from' to 'to' (dense indices)
+        // Infinity means 'to' is provably unreachable from 'from'
+        double lowerBound(int from, int to) const;
+
+    private:
+        size_t nodeCount = 0;
+        uint64_t graphLayout = 0;
+        uint64_t graphVersion = 0;
+        std::vector<int> landmarks;
+
+        // Node-major tables: row v holds size() entries, so one heuristic
+        // evaluation reads a single contiguous row
+        std::vector<double> fromLandmark; // d(L, v)
+        std::vector<double> toLandmark; // d(v, L)
+    };
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef LIVE_GRAPH_HPP
+#define LIVE_GRAPH_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/router.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace RoutePlanner {
+    // Road network whose edge costs change while queries run (traffic feeds)
+    // Every update batch builds a new immutable CompactGraph off to the side and
+    // publishes it with one pointer swap, RCU style. Readers grab the current
+    // snapshot and keep it alive for as long as they use it, so a query in flight
+    // finishes on the version it started with
+    // Not lock-free: std::atomic_load / std::atomic_store on a shared_ptr take a
+    // short lock from a global pool in libstdc++, held only for the pointer and
+    // refcount copy. Readers never wait for a batch being rebuilt, but they do
+    // contend briefly with each other and with the swap
+    // Landmarks and hierarchies built on an older snapshot are not exact after
+    // updates; rebuild them from a fresh snapshot() (routing with stale landmarks throws)
+    class LiveGraph {
+    public:
+        explicit LiveGraph(CompactGraph graph);
+
+        LiveGraph(const LiveGraph&) = delete;
+        LiveGraph& operator=(const LiveGraph&) = delete;
+
+        // Current version, safe to call from any thread
+        std::shared_ptr<const CompactGraph> snapshot() const;
+
+        // Apply a batch and publish it as the next version
+        // Writers are serialised; readers only wait out the final pointer swap, not the rebuild
+        // Return the number of updates that matched an edge
+        size_t applyUpdates(const std::vector<WeightUpdate>& updates);
+
+        // Router::computePath on the current snapshot
+        RouteResult computePath(int startId, int endId, const RouteOptions& options = RouteOptions{}) const;
+
+    private:
+        // Only accessed through std::atomic_load / std::atomic_store
+        std::shared_ptr<const CompactGraph> current;
+        std::mutex writer;
+    };
+}
+
+#endif
@@ -3,16 +3,25 @@
 
 #include "route_planner/graph.hpp"
 #include <string>
+#include <vector>
 
 namespace RoutePlanner {
+    // Malformed input line, 1-based line number in the source file
+    struct ParseError {
+        size_t line;
+        std::string message;
+    };
+
     class MapLoader {
         public:
             // static: method belongs to class, not instance
             // Return true if successful, false otherwise
             // pass 'Graph& graph' by ref to modify original object
-            static bool loadNodes(const std::string& filepath, Graph& graph);
-            static bool loadEdges(const std::string& filepath, Graph& graph);
+            // Files are memory-mapped and parsed in parallel chunks
+            // Bad lines are skipped; they go to 'errors' if given, else a short report on std::cerr
+            static bool loadNodes(const std::string& filepath, Graph& graph, std::vector<ParseError>* errors = nullptr);
+            static bool loadEdges(const std::string& filepath, Graph& graph, std::vector<ParseError>* errors = nullptr);
     };
 }
 
-#endif
\ No newline at end of file
+#endif
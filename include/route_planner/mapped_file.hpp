@@ -0,0 +1,46 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace RoutePlanner {
+    // Read-only view of a whole file
+    // Memory-mapped on POSIX, so pages load lazily and are shared through the page cache
+    // Other platforms fall back to reading the file into a buffer
+    class MappedFile {
+    public:
+        // Read-ahead hint for the mapping
+        enum class Access {
+            Sequential, // Parsers reading front to back
+            Random // Lookups all over the file, e.g. routing on a snapshot
+        };
+
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Return true if successful, false otherwise
+        bool open(const std::string& filepath, Access access = Access::Sequential);
+        void close();
+
+        bool isOpen() const { return opened; }
+        const char* data() const { return begin; }
+        size_t size() const { return length; }
+        std::string_view view() const { return std::string_view(begin, length); }
+
+    private:
+        const char* begin = nullptr;
+        size_t length = 0;
+        bool opened = false;
+        bool mapped = false; // begin points at an mmap region
+        std::vector<char> buffer; // Fallback storage when not mapped
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef NAME_INDEX_HPP
+#define NAME_INDEX_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace RoutePlanner {
+    // One autocomplete suggestion. Duplicate names collapse into a single match
+    struct NameMatch {
+        std::string_view name; // Points into the graph's interned names
+        int id; // Smallest external ID with this name
+        size_t count; // How many nodes share the name
+    };
+
+    // Name lookups for a frozen graph
+    // Exact matches go through a hash map, prefix queries through the names sorted
+    // lexicographically, so top-k completion is one binary search plus k steps
+    // Matching is byte-exact; MapLoader lowercases names, so lowercase queries too
+    class NameIndex {
+    public:
+        NameIndex() = default;
+
+        // Keeps a (shared) copy of 'graph' so the name views stay valid
+        explicit NameIndex(const CompactGraph& graph);
+
+        // Smallest external ID with exactly this name, -1 if not found
+        int find(std::string_view name) const;
+
+        // Every external ID with exactly this name, ascending
+        std::vector<int> findAll(std::string_view name) const;
+
+        // Up to 'k' distinct names starting with 'prefix', in lexicographic order
+        // An exact match, if any, always comes first
+        std::vector<NameMatch> complete(std::string_view prefix, size_t k) const;
+
+    private:
+        // Run of equal names in 'sorted'
+        struct Range {
+            uint32_t first;
+            uint32_t count;
+        };
+
+        CompactGraph graph;
+        std::vector<int> sorted; // Dense indices by (name, ID)
+        std::unordered_map<std::string_view, Range> ranges; // Name -> run in 'sorted'
+    };
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef NODE_ORDER_HPP
+#define NODE_ORDER_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include <vector>
+
+namespace RoutePlanner {
+    // Layouts that put nodes which are searched together next to each other in
+    // memory, so relaxing an edge usually hits a cache line that is already loaded
+    enum class NodeOrder {
+        Hilbert, // Along a Hilbert curve over x/y: close on the map, close in memory
+        BreadthFirst, // BFS over roads (both directions), one component after another
+        CuthillMcKee // Reverse Cuthill-McKee: BFS from a low-degree node by ascending degree, reversed
+    };
+
+    class NodeOrdering {
+    public:
+        // Permutation for CompactGraph::permuted(): entry i is the current index of the node moved to i
+        static std::vector<int> compute(const CompactGraph& graph, NodeOrder order);
+
+        // graph.permuted(compute(graph, order)). Build landmarks, hierarchies and
+        // spatial indexes after this, they hold dense indices (routing with older
+        // landmarks throws, see CompactGraph::layout())
+        static CompactGraph apply(const CompactGraph& graph, NodeOrder order);
+    };
+}
+
+#endif
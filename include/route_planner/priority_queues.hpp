@@ -0,0 +1,251 @@
+#ifndef PRIORITY_QUEUES_HPP
+#define PRIORITY_QUEUES_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+namespace RoutePlanner {
+    // Entry in the search frontier, ordered by key (gScore + heuristic)
+    struct QueueEntry {
+        double key;
+        int id;
+
+        // Min-heap via std::greater
+        bool operator>(const QueueEntry& other) const {
+            return key > other.key;
+        }
+    };
+
+    // Frontier policies for the router's searches
+    // All share one interface: clear(numNodes), push(id, key), top(), pop(), empty(), size()
+    // push() on a node already in the queue either adds a duplicate (lazy queues)
+    // or lowers its key (indexed queues); callers skip settled nodes on pop either way
+
+    // Lazy binary heap over a caller-owned vector (SearchContext::queue())
+    // Cheapest per operation, but stale duplicates stay until popped
+    class BinaryHeap {
+    public:
+        explicit BinaryHeap(std::vector<QueueEntry>& storage) : entries(storage) {}
+
+        void clear(size_t) { entries.clear(); }
+        bool empty() const { return entries.empty(); }
+        size_t size() const { return entries.size(); }
+
+        void push(int id, double key) {
+            entries.push_back({key, id});
+            std::push_heap(entries.begin(), entries.end(), std::greater<QueueEntry>());
+        }
+
+        const QueueEntry& top() const { return entries.front(); }
+
+        QueueEntry pop() {
+            std::pop_heap(entries.begin(), entries.end(), std::greater<QueueEntry>());
+            QueueEntry entry = entries.back();
+            entries.pop_back();
+            return entry;
+        }
+
+    private:
+        std::vector<QueueEntry>& entries;
+    };
+
+    // D-ary heap with a position per node, so push() is a decrease-key
+    // Holds each node at most once: size is bounded by the node count
+    // Wider nodes make the heap shallower and keep siblings on one cache line
+    template <unsigned Arity>
+    class IndexedHeap {
+    public:
+        // Positions of nodes still queued from the last search are cleared here,
+        // everything else already reads as absent, so this is O(queue size)
+        void clear(size_t numNodes) {
+            for (const auto& entry : entries) positions[entry.id] = ABSENT;
+            entries.clear();
+            if (positions.size() < numNodes) positions.resize(numNodes, ABSENT);
+        }
+
+        bool empty() const { return entries.empty(); }
+        size_t size() const { return entries.size(); }
+
+        bool contains(int id) const { return positions[id] != ABSENT; }
+
+        // Insert, or lower the key if 'id' is queued with a larger one
+        void push(int id, double key) {
+            uint32_t pos = positions[id];
+            if (pos == ABSENT) {
+                pos = static_cast<uint32_t>(entries.size());
+                entries.push_back({key, id});
+            } else if (key < entries[pos].key) {
+                entries[pos].key = key;
+            } else {
+                return;
+            }
+            siftUp(pos);
+        }
+
+        const QueueEntry& top() const { return entries.front(); }
+
+        QueueEntry pop() {
+            QueueEntry entry = entries.front();
+            positions[entry.id] = ABSENT;
+            QueueEntry last = entries.back();
+            entries.pop_back();
+            if (!entries.empty()) {
+                entries[0] = last;
+                siftDown(0);
+            }
+            return entry;
+        }
+
+        size_t bytesReserved() const {
+            return entries.capacity() * sizeof(QueueEntry) + positions.capacity() * sizeof(uint32_t);
+        }
+
+    private:
+        static constexpr uint32_t ABSENT = UINT32_MAX;
+
+        // Hole-based sifts: move the entry once instead of swapping at every level
+        void siftUp(uint32_t pos) {
+            QueueEntry entry = entries[pos];
+            while (pos > 0) {
+                uint32_t parent = (pos - 1) / Arity;
+                if (!(entry.key < entries[parent].key)) break;
+                entries[pos] = entries[parent];
+                positions[entries[pos].id] = pos;
+                pos = parent;
+            }
+            entries[pos] = entry;
+            positions[entry.id] = pos;
+        }
+
+        void siftDown(uint32_t pos) {
+            QueueEntry entry = entries[pos];
+            const uint32_t count = static_cast<uint32_t>(entries.size());
+            while (true) {
+                uint32_t first = pos * Arity + 1;
+                if (first >= count) break;
+                uint32_t best = first;
+                uint32_t end = std::min(first + Arity, count);
+                for (uint32_t child = first + 1; child < end; ++child) {
+                    if (entries[child].key < entries[best].key) best = child;
+                }
+                if (!(entries[best].key < entry.key)) break;
+                entries[pos] = entries[best];
+                positions[entries[pos].id] = pos;
+                pos = best;
+            }
+            entries[pos] = entry;
+            positions[entry.id] = pos;
+        }
+
+        std::vector<QueueEntry> entries;
+        std::vector<uint32_t> positions; // Node -> index in entries, ABSENT if not queued
+    };
+
+    using FourAryHeap = IndexedHeap<4>;
+
+    // Monotone radix heap: every pushed key must be >= the last popped key,
+    // which holds for Dijkstra and for A* with a consistent heuristic
+    // Non-negative doubles order the same as their bit patterns, so the raw
+    // bits are the radix and no weight quantisation is needed
+    // Entries live in 65 buckets by the highest bit that differs from the
+    // last popped key; each entry moves down at most 64 times in total
+    class RadixHeap {
+    public:
+        void clear(size_t) {
+            for (auto& bucket : buckets) bucket.clear();
+            last = 0;
+            count = 0;
+        }
+
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+
+        // Lazy like BinaryHeap: a better key for a queued node adds a duplicate
+        void push(int id, double key) {
+            // Rounding in g + h can land an ulp below the last pop, clamp it back
+            uint64_t bits = std::max(toBits(key), last);
+            buckets[bucketOf(bits)].push_back({bits, id});
+            ++count;
+        }
+
+        QueueEntry top() {
+            refill();
+            const Item& item = buckets[0].back();
+            return {fromBits(item.bits), item.id};
+        }
+
+        QueueEntry pop() {
+            refill();
+            Item item = buckets[0].back();
+            buckets[0].pop_back();
+            --count;
+            return {fromBits(item.bits), item.id};
+        }
+
+        size_t bytesReserved() const {
+            size_t bytes = 0;
+            for (const auto& bucket : buckets) bytes += bucket.capacity() * sizeof(Item);
+            return bytes;
+        }
+
+    private:
+        struct Item {
+            uint64_t bits;
+            int id;
+        };
+
+        // Negative keys (and -0.0) clamp to zero
+        static uint64_t toBits(double key) {
+            if (!(key > 0.0)) return 0;
+            uint64_t bits;
+            std::memcpy(&bits, &key, sizeof(bits));
+            return bits;
+        }
+
+        static double fromBits(uint64_t bits) {
+            double key;
+            std::memcpy(&key, &bits, sizeof(key));
+            return key;
+        }
+
+        size_t bucketOf(uint64_t bits) const {
+            uint64_t diff = bits ^ last;
+            if (diff == 0) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+            return 64 - __builtin_clzll(diff);
+#else
+            size_t bucket = 0;
+            while (diff) {
+                diff >>= 1;
+                ++bucket;
+            }
+            return bucket;
+#endif
+        }
+
+        // Make bucket 0 hold the minimum: redistribute the first non-empty
+        // bucket around its smallest key, which becomes the new 'last'
+        void refill() {
+            if (!buckets[0].empty()) return;
+            size_t i = 1;
+            while (buckets[i].empty()) ++i;
+
+            std::vector<Item>& source = buckets[i];
+            last = std::min_element(source.begin(), source.end(),
+                                    [](const Item& a, const Item& b) { return a.bits < b.bits; })->bits;
+            // Every item lands in a lower bucket, so 'source' isn't appended to while iterating
+            for (const Item& item : source) buckets[bucketOf(item.bits)].push_back(item);
+            source.clear();
+        }
+
+        std::array<std::vector<Item>, 65> buckets;
+        uint64_t last = 0; // Bits of the last popped (or refilled) minimum
+        size_t count = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef ROUTE_CACHE_HPP
+#define ROUTE_CACHE_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/router.hpp"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace RoutePlanner {
+    struct RouteCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0; // Estimated, compared against the budget
+    };
+
+    // Thread-safe LRU cache of RouteResults for repeated queries
+    // Keyed by (graph version, start, end, engine options), so entries for a
+    // graph that has since been mutated can never be served; they just age out
+    // Split into shards with one lock each, so concurrent lookups rarely contend
+    class RouteCache {
+    public:
+        // 'maxBytes' is split evenly over the shards
+        explicit RouteCache(size_t maxBytes = 64 << 20, size_t numShards = 16);
+
+        // Router::computePath, answered from the cache when possible
+        // Hits return stats all zero, no search was run
+        // Two threads missing the same key at once both compute it
+        // Cancelled searches (RouteOptions::cancel) are not stored
+        RouteResult computePath(const CompactGraph& graph, int startId, int endId,
+                                const RouteOptions& options = RouteOptions{});
+
+        // Return true and fill 'result' if cached
+        bool lookup(const CompactGraph& graph, int startId, int endId, const RouteOptions& options,
+                    RouteResult& result);
+
+        void insert(const CompactGraph& graph, int startId, int endId, const RouteOptions& options,
+                    const RouteResult& result);
+
+        void clear();
+
+        // Summed over shards
+        RouteCacheStats stats() const;
+
+    private:
+        // Everything that can change the answer; collectStats doesn't
+        struct Key {
+            uint64_t graphVersion;
+            int startId;
+            int endId;
+            const void* landmarks;
+            HeuristicType heuristic;
+            QueueType queue; // Ties may resolve to different, equally short paths
+            bool bidirectional;
+
+            bool operator==(const Key& other) const;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        struct Entry {
+            Key key;
+            std::shared_ptr<const RouteResult> result; // Copied out after the lock is released
+            size_t bytes;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::list<Entry> lru; // Most recently used first
+            std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+            size_t bytes = 0;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+        };
+
+        static Key makeKey(const CompactGraph& graph, int startId, int endId, const RouteOptions& options);
+        Shard& shardOf(const Key& key);
+
+        std::vector<std::unique_ptr<Shard>> shards; // Shard holds a mutex, so not movable
+        size_t shardBudget;
+    };
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef ROUTE_SERVER_HPP
+#define ROUTE_SERVER_HPP
+
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/router.hpp"
+#include <iosfwd>
+
+namespace RoutePlanner {
+    struct ServerOptions {
+        size_t workers = 0; // 0 = one per hardware core
+        size_t queueCapacity = 0; // Batches parsed ahead of the workers, 0 = 4 per worker
+        size_t batchSize = 64; // Requests handed to a worker at once
+        RouteOptions route; // Engine used for every request
+    };
+
+    // Headless line protocol, one request per line:
+    //   <tag> <startId> <endId>
+    // Answers come back in completion order, not request order, tagged:
+    //   <tag> ok <totalDist> <id> <id> ...
+    //   <tag> none                          (no path)
+    //   <tag> error <message>               (malformed line, unknown node)
+    // Blank lines and lines starting with '#' are ignored
+    //
+    // Three stages: the calling thread parses, a fixed set of workers routes on
+    // the shared read-only graph, a writer thread flushes answers in bulk
+    // The parse queue is bounded: when workers fall behind, the reader stops
+    // reading, so a producer on the other end of the pipe blocks (backpressure)
+    class RouteServer {
+    public:
+        // Serve until 'in' is exhausted and every answer is written
+        // Return the number of requests answered
+        static size_t serve(const CompactGraph& graph, std::istream& in, std::ostream& out,
+                            const ServerOptions& options = ServerOptions{});
+    };
+}
+
+#endif
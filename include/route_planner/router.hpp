@@ -2,6 +2,11 @@
 #define ROUTER_HPP
 
 #include "graph.hpp"
+#include "compact_graph.hpp"
+#include "search_context.hpp"
+#include "search_stats.hpp"
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <unordered_map>
 
@@ -12,12 +17,128 @@ namespace RoutePlanner {
         std::vector<int> path; // Seq of Node IDs
         double totalDist; // Sum of edge weights
         bool success; // True if path found
+        SearchStats stats = {}; // Filled when RouteOptions::collectStats is set
+    };
+
+    class CompressedGraph;
+    class Landmarks;
+    class ThreadPool;
+
+    // Dense sources x targets cost table
+    struct DistanceMatrix {
+        size_t rows = 0; // One per source
+        size_t cols = 0; // One per target
+        std::vector<double> distances; // Row-major, infinity if unreachable
+        std::vector<std::vector<int>> paths; // Row-major, only filled when paths were requested
+
+        double at(size_t row, size_t col) const { return distances[row * cols + col]; }
+        const std::vector<int>& path(size_t row, size_t col) const { return paths[row * cols + col]; }
+    };
+
+    // Everything reachable from one source within a cost budget
+    struct Isochrone {
+        std::vector<int> nodes; // External IDs, cheapest first, source included
+        std::vector<double> costs; // Cost from the source, parallel to 'nodes'
+        // Counter-clockwise convex hull of the reached area, only filled on request
+        // Covers the reached nodes plus the points where the budget runs out along edges
+        std::vector<double> boundaryX, boundaryY;
+    };
+
+    // A* lower bound used by the CompactGraph searches
+    enum class HeuristicType {
+        Euclidean, // Straight-line distance, only exact if weights are at least the geometric length
+        Zero, // No heuristic, plain Dijkstra
+        Landmark // ALT bounds from RouteOptions::landmarks, exact on any weights
+    };
+
+    // Frontier used by the CompactGraph searches (see priority_queues.hpp)
+    enum class QueueType {
+        BinaryHeap, // Lazy binary heap, duplicates skipped on pop
+        FourAryHeap, // Indexed 4-ary heap with decrease-key, at most one entry per node
+        RadixHeap // Monotone radix heap, keys must not decrease: assumes a consistent heuristic
+    };
+
+    // Engine options for a CompactGraph query
+    struct RouteOptions {
+        HeuristicType heuristic = HeuristicType::Euclidean;
+        const Landmarks* landmarks = nullptr; // Built with Landmarks::select on the same graph
+        bool bidirectional = false; // Search from both ends, meet in the middle
+        QueueType queue = QueueType::BinaryHeap;
+        bool collectStats = false; // Fill RouteResult::stats and feed StatsAggregator::global()
+
+        // Polled every few hundred expanded nodes; once it reads true the search gives up
+        // and returns success == false (see AsyncRouter, which supersedes queries this way)
+        const std::atomic<bool>* cancel = nullptr;
+
+        // Called on the searching thread every few hundred expanded nodes, and once at
+        // the end, with the external IDs expanded since the previous call
+        // Lets a UI draw the frontier as it grows; keep it cheap, it runs inside the search
+        std::function<void(const std::vector<int>&)> onProgress;
     };
 
     class Router {
         public:
             // pass 'const Graph&' bc router should read map, not modify it
             static RouteResult computePath(const Graph& graph, int startId, int endId);
+
+            // Same search over frozen CSR layout, no hash lookups in the inner loop
+            // IDs in and out are external node IDs
+            // Uses a thread-local SearchContext
+            static RouteResult computePath(const CompactGraph& graph, int startId, int endId);
+
+            // Caller-owned workspace, reuse it across queries to skip per-query setup
+            static RouteResult computePath(const CompactGraph& graph, int startId, int endId, SearchContext& context);
+
+            // Pick the heuristic (and later engine settings) per query
+            // Throws std::invalid_argument if options ask for landmarks that don't match the graph
+            static RouteResult computePath(const CompactGraph& graph, int startId, int endId, const RouteOptions& options);
+            static RouteResult computePath(const CompactGraph& graph, int startId, int endId,
+                                           const RouteOptions& options, SearchContext& context);
+
+            // Always bidirectional, with one caller-owned workspace per direction
+            // The overloads above use a thread-local backward workspace when options.bidirectional is set
+            static RouteResult computePath(const CompactGraph& graph, int startId, int endId, const RouteOptions& options,
+                                           SearchContext& forward, SearchContext& backward);
+
+            // Same engines over the compressed edge store, which decodes edges inside the
+            // relaxation loop; costs are off by at most resolution() per edge (see compressed_graph.hpp)
+            // Landmarks built on the source CompactGraph can be used here
+            static RouteResult computePath(const CompressedGraph& graph, int startId, int endId,
+                                           const RouteOptions& options = RouteOptions{});
+            static RouteResult computePath(const CompressedGraph& graph, int startId, int endId,
+                                           const RouteOptions& options, SearchContext& context);
+
+            // Many-to-many costs: one Dijkstra per source that stops once every target is settled
+            // Rows run in parallel on 'pool' (ThreadPool::shared() if null); graph is only read
+            // Unknown source/target IDs give infinite entries
+            static DistanceMatrix distanceMatrix(const CompactGraph& graph, const std::vector<int>& sources,
+                                                 const std::vector<int>& targets, bool withPaths = false,
+                                                 ThreadPool* pool = nullptr);
+
+            // Freezes once, then as above
+            static DistanceMatrix distanceMatrix(const Graph& graph, const std::vector<int>& sources,
+                                                 const std::vector<int>& targets, bool withPaths = false,
+                                                 ThreadPool* pool = nullptr);
+
+            // Up to 'k' loopless routes, cheapest first (Yen's algorithm), for offering alternatives
+            // Every spur search shares one reverse shortest-path tree from 'end': it is the A*
+            // heuristic, and spurs whose tree path isn't blocked skip the search entirely
+            // Empty if the IDs are unknown or no route exists
+            static std::vector<RouteResult> kShortestPaths(const CompactGraph& graph, int startId, int endId, size_t k);
+            static std::vector<RouteResult> kShortestPaths(const CompactGraph& graph, int startId, int endId, size_t k,
+                                                           SearchContext& forward, SearchContext& backward);
+
+            // One-to-all Dijkstra that stops at 'budget' (isochrone / service area)
+            // Unknown source gives an empty result
+            // Uses a thread-local SearchContext; pass one to reuse it across many sources
+            static Isochrone reachableWithin(const CompactGraph& graph, int sourceId, double budget,
+                                             bool withBoundary = false);
+            static Isochrone reachableWithin(const CompactGraph& graph, int sourceId, double budget,
+                                             SearchContext& context, bool withBoundary = false);
+
+            // Freezes on every call; freeze once yourself for repeated queries
+            static Isochrone reachableWithin(const Graph& graph, int sourceId, double budget,
+                                             bool withBoundary = false);
     };
 }
 
@@ -0,0 +1,91 @@
+#ifndef SEARCH_CONTEXT_HPP
+#define SEARCH_CONTEXT_HPP
+
+#include "priority_queues.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+namespace RoutePlanner {
+    // Reusable scratch space for searches over dense node indices
+    // Per-node state is stamped with a generation number, so reset() is O(1):
+    // a slot whose stamp is older than the current generation reads as untouched
+    // Keep one per thread and pass it to every query. After warm-up,
+    // back-to-back queries on the same graph do not allocate
+    class SearchContext {
+    public:
+        SearchContext() = default;
+
+        // Start a new query over a graph with 'numNodes' nodes
+        // Only grows storage, never shrinks
+        void reset(size_t numNodes);
+
+        // Node has a tentative distance in this query
+        bool reached(int i) const { return slots[i].stamp >= generation; }
+
+        // Node has been expanded (distance is final for Dijkstra / consistent A*)
+        bool settled(int i) const { return slots[i].stamp == generation + 1; }
+
+        double dist(int i) const {
+            return reached(i) ? slots[i].dist : std::numeric_limits<double>::infinity();
+        }
+        int parent(int i) const { return reached(i) ? slots[i].parent : -1; }
+
+        // Record a (better) tentative distance
+        void update(int i, double dist, int parent) {
+            slots[i].dist = dist;
+            slots[i].parent = parent;
+            slots[i].stamp = generation;
+        }
+
+        // Same, parent left as it was, for searches that only want the cost
+        void update(int i, double dist) {
+            slots[i].dist = dist;
+            slots[i].stamp = generation;
+        }
+
+        void settle(int i) {
+            slots[i].stamp = generation + 1;
+            ++settledCount;
+        }
+
+        // Nodes settled since the last reset(), a machine-independent measure of work
+        size_t numSettled() const { return settledCount; }
+
+        // Frontier storage, emptied on reset() but keeps capacity
+        std::vector<QueueEntry>& queue() { return heap; }
+
+        // Alternative frontiers (see priority_queues.hpp), only sized once used
+        // Not touched by reset(), call their clear(numNodes) before a search
+        FourAryHeap& fourAryHeap() { return fourAry; }
+        RadixHeap& radixHeap() { return radix; }
+
+        size_t capacity() const { return slots.size(); }
+
+        // Heap memory held by this workspace
+        size_t bytesReserved() const {
+            return slots.capacity() * sizeof(Slot) + heap.capacity() * sizeof(QueueEntry)
+                + fourAry.bytesReserved() + radix.bytesReserved();
+        }
+
+    private:
+        // Dist, parent and stamp together: one cache line touch per node
+        struct Slot {
+            double dist;
+            int parent;
+            uint32_t stamp;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<QueueEntry> heap;
+        FourAryHeap fourAry;
+        RadixHeap radix;
+        size_t settledCount = 0;
+
+        // Even numbers only: 'generation' means reached, 'generation + 1' means settled
+        uint32_t generation = 2;
+    };
+}
+
+#endif
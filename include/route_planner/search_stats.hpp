@@ -0,0 +1,113 @@
+#ifndef SEARCH_STATS_HPP
+#define SEARCH_STATS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace RoutePlanner {
+    // Work done by one query. All zero unless stats were requested
+    struct SearchStats {
+        uint64_t settled = 0; // Nodes expanded
+        uint64_t stalePops = 0; // Heap pops of nodes that were already settled
+        uint64_t pushes = 0; // Heap pushes
+        uint64_t relaxations = 0; // Edges scanned
+        uint64_t peakQueueSize = 0; // Largest heap size seen (per side for bidirectional)
+        uint64_t bytesAllocated = 0; // Workspace and result growth, 0 once contexts are warm
+
+        // Wall time per phase, microseconds
+        double setupMicros = 0.0; // ID lookup and workspace reset
+        double searchMicros = 0.0;
+        double pathMicros = 0.0; // Parent walk / shortcut unpacking
+    };
+
+    // Hooks the search loops call. NoStats does nothing and inlines away, so
+    // the default instantiation of a search is the same code as before.
+    // StatsRecorder fills a SearchStats. Loops take the recorder as a template
+    // parameter, so the choice is made once per query, not per edge
+    struct NoStats {
+        void push(size_t) {}
+        void stalePop() {}
+        void settle() {}
+        void relax() {}
+        void allocated(size_t) {}
+        void beginPhase() {}
+        void endPhase(double SearchStats::*) {}
+    };
+
+    struct StatsRecorder {
+        SearchStats& stats;
+        std::chrono::steady_clock::time_point phaseStart = {};
+
+        // 'queueSize' is the size after the push
+        void push(size_t queueSize) {
+            ++stats.pushes;
+            stats.peakQueueSize = std::max<uint64_t>(stats.peakQueueSize, queueSize);
+        }
+        void stalePop() { ++stats.stalePops; }
+        void settle() { ++stats.settled; }
+        void relax() { ++stats.relaxations; }
+        void allocated(size_t bytes) { stats.bytesAllocated += bytes; }
+
+        void beginPhase() { phaseStart = std::chrono::steady_clock::now(); }
+        void endPhase(double SearchStats::* field) {
+            stats.*field += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - phaseStart).count();
+        }
+    };
+
+    // Return 'result' from inside the setup phase (unknown IDs, start == end),
+    // closing the phase first so the query is timed like any other
+    template <typename Recorder, typename Result>
+    Result endSetup(Recorder& recorder, Result result) {
+        recorder.endPhase(&SearchStats::setupMicros);
+        return result;
+    }
+
+    // Process-wide totals of every query run with stats on, per engine label
+    // Thread-safe; scrape with prometheus()
+    class StatsAggregator {
+    public:
+        static StatsAggregator& global();
+
+        void record(const std::string& engine, const SearchStats& stats);
+
+        // Totals in the Prometheus text exposition format
+        std::string prometheus() const;
+
+        // Totals for one engine, all zero if never recorded
+        SearchStats totals(const std::string& engine) const;
+        uint64_t queries(const std::string& engine) const;
+
+        void reset();
+
+    private:
+        struct Totals {
+            uint64_t queries = 0;
+            SearchStats sum; // peakQueueSize holds the max instead of a sum
+        };
+
+        mutable std::mutex mutex;
+        std::map<std::string, Totals> engines; // Ordered, so output is stable
+    };
+
+    // Run 'search(recorder)' with a StatsRecorder if 'collect', else with NoStats
+    // Collected stats go to result.stats and to StatsAggregator::global() under 'engine'
+    template <typename Search>
+    auto runWithStats(bool collect, const char* engine, Search search) {
+        if (!collect) {
+            NoStats recorder;
+            return search(recorder);
+        }
+        SearchStats stats;
+        StatsRecorder recorder{stats};
+        auto result = search(recorder);
+        result.stats = stats;
+        StatsAggregator::global().record(engine, stats);
+        return result;
+    }
+}
+
+#endif
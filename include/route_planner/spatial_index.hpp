@@ -0,0 +1,49 @@
+#ifndef SPATIAL_INDEX_HPP
+#define SPATIAL_INDEX_HPP
+
+#include "route_planner/graph.hpp"
+#include "route_planner/compact_graph.hpp"
+#include <limits>
+#include <vector>
+
+namespace RoutePlanner {
+    // 2-d tree over node coordinates for snapping and hit testing
+    // Stored implicitly: the median of each range is the split point, so there are
+    // no child pointers and a query touches O(log N) nodes on typical maps
+    // Results are external node IDs; equal distances resolve to the smaller ID
+    class SpatialIndex {
+    public:
+        SpatialIndex() = default;
+
+        // Snapshot of the coordinates, later graph changes are not reflected
+        explicit SpatialIndex(const Graph& graph);
+        explicit SpatialIndex(const CompactGraph& graph);
+
+        size_t size() const { return points.size(); }
+
+        // Closest node to (x, y) within 'maxDistance', -1 if none
+        int nearest(double x, double y, double maxDistance = std::numeric_limits<double>::infinity()) const;
+
+        // Up to 'k' closest nodes, nearest first
+        std::vector<int> kNearest(double x, double y, size_t k) const;
+
+        // Nodes with minX <= x <= maxX and minY <= y <= maxY, in no particular order
+        std::vector<int> withinBox(double minX, double minY, double maxX, double maxY) const;
+
+        // Nodes within 'radius' of (x, y), in no particular order
+        std::vector<int> withinRadius(double x, double y, double radius) const;
+
+    private:
+        struct Point {
+            double x, y;
+            int id;
+        };
+
+        // Split axis alternates per level: x at even depth, y at odd
+        void build(size_t lo, size_t hi, int depth);
+
+        std::vector<Point> points; // In tree order
+    };
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace RoutePlanner {
+    // Fixed set of worker threads pulling tasks from a shared FIFO queue
+    class ThreadPool {
+    public:
+        // 0 = one thread per hardware core
+        explicit ThreadPool(size_t numThreads = 0);
+
+        // Finishes queued tasks, then joins workers
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size() const { return workers.size(); }
+
+        // Queue a task, the future carries its result or exception
+        template <typename F>
+        auto submit(F&& task) -> std::future<decltype(task())> {
+            using Result = decltype(task());
+            // std::function needs copyable targets, so share the packaged_task
+            auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            std::future<Result> future = packaged->get_future();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.push([packaged]() { (*packaged)(); });
+            }
+            wakeup.notify_one();
+            return future;
+        }
+
+        // Run body(i) for every i in [0, count) and wait for all of them
+        // The calling thread works too, so this is safe to call from inside a task
+        // Rethrows the first exception thrown by 'body'
+        void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+        // Process-wide pool sized to the machine, created on first use
+        static ThreadPool& shared();
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        bool stopping = false;
+    };
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define VISUALIZER_HPP
 
 #include "route_planner/graph.hpp"
+#include "route_planner/compact_graph.hpp"
 #include <SFML/Graphics.hpp>
 #include <vector>
 
@@ -9,6 +10,7 @@ namespace RoutePlanner {
     // The "Promise" to the compiler
     void drawAsciiMap(const Graph& graph, const std::vector<int>& path);
     void displaySFML(const Graph& graph);
+    void displaySFML(const CompactGraph& graph); // e.g. straight from a snapshot
 }
 
 #endif
\ No newline at end of file
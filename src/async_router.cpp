@@ -0,0 +1,112 @@
+#include "route_planner/async_router.hpp"
+
+namespace RoutePlanner {
+    bool RouteHandle::ready() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->done;
+    }
+
+    void RouteHandle::wait() const {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [this]() { return state->done; });
+    }
+
+    RouteResult RouteHandle::get() const {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [this]() { return state->done; });
+        if (state->error) std::rethrow_exception(state->error);
+        return state->result;
+    }
+
+    void RouteHandle::cancel() {
+        state->cancelFlag = true;
+    }
+
+    bool RouteHandle::cancelled() const {
+        return state->cancelFlag;
+    }
+
+    std::vector<int> RouteHandle::takeProgress() {
+        std::vector<int> taken;
+        std::lock_guard<std::mutex> lock(state->mutex);
+        taken.swap(state->progress);
+        return taken;
+    }
+
+    AsyncRouter::AsyncRouter(const CompactGraph& graph) : graph(graph), worker([this]() { workerLoop(); }) {}
+
+    AsyncRouter::~AsyncRouter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            if (latest) latest->cancelFlag = true;
+            if (pending) {
+                finish(*pending->state, { {}, 0.0, false });
+                pending.reset();
+            }
+        }
+        wakeup.notify_all();
+        worker.join();
+    }
+
+    RouteHandle AsyncRouter::submit(int startId, int endId, const RouteOptions& options) {
+        auto state = std::make_shared<RouteHandle::State>();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (latest) latest->cancelFlag = true; // Stops it if running
+            if (pending) finish(*pending->state, { {}, 0.0, false }); // Never started
+            pending = Job{startId, endId, options, state};
+            latest = state;
+        }
+        wakeup.notify_one();
+        return RouteHandle(state);
+    }
+
+    void AsyncRouter::cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (latest) latest->cancelFlag = true;
+    }
+
+    void AsyncRouter::finish(RouteHandle::State& state, RouteResult result, std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.result = std::move(result);
+            state.error = error;
+            state.done = true;
+        }
+        state.finished.notify_all();
+    }
+
+    void AsyncRouter::workerLoop() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeup.wait(lock, [this]() { return stopping || pending; });
+                if (stopping) return;
+                job = std::move(*pending);
+                pending.reset();
+            }
+
+            RouteHandle::State& state = *job.state;
+            RouteOptions options = job.options;
+            options.cancel = &state.cancelFlag;
+            options.onProgress = [&state, user = job.options.onProgress](const std::vector<int>& ids) {
+                if (user) user(ids);
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.progress.insert(state.progress.end(), ids.begin(), ids.end());
+            };
+
+            try {
+                RouteResult result = options.bidirectional
+                    ? Router::computePath(graph, job.startId, job.endId, options, forward, backward)
+                    : Router::computePath(graph, job.startId, job.endId, options, forward);
+                // Superseded while running: report it cancelled even if the search got to finish
+                if (state.cancelFlag) result = { {}, 0.0, false };
+                finish(state, std::move(result));
+            } catch (...) {
+                finish(state, { {}, 0.0, false }, std::current_exception());
+            }
+        }
+    }
+}
@@ -0,0 +1,469 @@
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/mapped_file.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace RoutePlanner {
+    namespace {
+        // Offsets of an empty graph, so offsets[0] etc. stay valid
+        const uint32_t EMPTY_OFFSETS[1] = {0};
+
+        // Snapshot layout: Header, section table, then 8-byte aligned sections
+        // Everything is written in native byte order; byteOrder catches a mismatch
+        constexpr char SNAPSHOT_MAGIC[4] = {'R', 'P', 'G', 'S'};
+        constexpr uint32_t SNAPSHOT_VERSION = 2; // 2 added SECTION_ID_ORDER
+        constexpr uint32_t OLDEST_SNAPSHOT_VERSION = 1; // Always has sorted IDs
+        constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+        constexpr size_t SECTION_ALIGNMENT = 8;
+
+        struct SnapshotHeader {
+            char magic[4];
+            uint32_t version;
+            uint32_t byteOrder;
+            uint32_t sectionCount;
+            uint64_t nodeCount;
+            uint64_t edgeCount;
+            uint64_t fileSize;
+            uint64_t checksum; // Over everything after the header
+        };
+
+        struct SectionEntry {
+            uint32_t tag;
+            uint32_t elementSize; // Guards against type changes between versions
+            uint64_t offset; // From start of file
+            uint64_t count; // Elements, not bytes
+        };
+
+        // Unknown tags are skipped on load, so new sections don't need a version bump
+        enum SectionTag : uint32_t {
+            SECTION_IDS = 1,
+            SECTION_OFFSETS,
+            SECTION_TARGETS,
+            SECTION_WEIGHTS,
+            SECTION_IN_OFFSETS,
+            SECTION_SOURCES,
+            SECTION_IN_WEIGHTS,
+            SECTION_XS,
+            SECTION_YS,
+            SECTION_NAME_OFFSETS,
+            SECTION_NAME_DATA,
+            SECTION_ID_ORDER, // Empty unless the graph was permuted
+        };
+
+        // FNV-1a over 64-bit words (plus the byte tail), several times faster than bytewise
+        uint64_t checksum(const char* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) {
+            constexpr uint64_t PRIME = 0x100000001b3ULL;
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                hash = (hash ^ word) * PRIME;
+            }
+            for (; i < size; ++i) {
+                hash = (hash ^ static_cast<unsigned char>(data[i])) * PRIME;
+            }
+            return hash;
+        }
+
+        // CompactGraph::layout() of a graph whose IDs are out of order
+        uint64_t permutedLayout(const int* ids, size_t n) {
+            return checksum(reinterpret_cast<const char*>(ids), n * sizeof(int));
+        }
+
+        size_t alignUp(size_t value) {
+            return (value + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        }
+
+        // Section payload before layout
+        struct SectionSource {
+            uint32_t tag;
+            uint32_t elementSize;
+            const void* data;
+            uint64_t count;
+        };
+
+        template <typename T>
+        SectionSource section(uint32_t tag, const T* data, size_t count) {
+            return {tag, static_cast<uint32_t>(sizeof(T)), data, count};
+        }
+
+        // CSR offsets start at 0, never decrease and end at 'total'
+        bool validOffsets(const uint32_t* offsets, uint64_t n, uint64_t total) {
+            if (offsets[0] != 0 || offsets[n] != total) return false;
+            for (uint64_t i = 0; i < n; ++i) {
+                if (offsets[i] > offsets[i + 1]) return false;
+            }
+            return true;
+        }
+
+        // Every entry is a dense index below 'n'
+        bool validIndices(const int* indices, uint64_t count, uint64_t n) {
+            for (uint64_t i = 0; i < count; ++i) {
+                if (indices[i] < 0 || static_cast<uint64_t>(indices[i]) >= n) return false;
+            }
+            return true;
+        }
+
+        // Find a section and check it holds 'count' elements of T
+        template <typename T>
+        const T* findSection(const char* base, const SectionEntry* table, uint32_t sectionCount,
+                             uint32_t tag, uint64_t count) {
+            for (uint32_t s = 0; s < sectionCount; ++s) {
+                const SectionEntry& entry = table[s];
+                if (entry.tag != tag) continue;
+                if (entry.elementSize != sizeof(T) || entry.count != count) return nullptr;
+                return reinterpret_cast<const T*>(base + entry.offset);
+            }
+            return nullptr; // Missing
+        }
+    }
+
+    struct CompactGraph::Buffers {
+        std::vector<int> ids;
+        std::vector<uint32_t> offsets;
+        std::vector<int> targets;
+        std::vector<double> weights;
+        std::vector<uint32_t> inOffsets;
+        std::vector<int> sources;
+        std::vector<double> inWeights;
+        std::vector<double> xs, ys;
+        std::vector<uint32_t> nameOffsets;
+        std::vector<char> nameData; // Not std::string: moving it must not move the bytes
+        std::vector<int> idOrder; // Empty when ids are sorted
+
+        // Reverse CSR from the forward one: count in-degrees, prefix sum, then scatter
+        void buildReverse() {
+            const size_t n = offsets.size() - 1;
+            inOffsets.assign(n + 1, 0);
+            for (int target : targets) ++inOffsets[target + 1];
+            for (size_t i = 0; i < n; ++i) inOffsets[i + 1] += inOffsets[i];
+
+            sources.resize(targets.size());
+            inWeights.resize(targets.size());
+            std::vector<uint32_t> cursor(inOffsets.begin(), inOffsets.end() - 1);
+            for (size_t u = 0; u < n; ++u) {
+                for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                    uint32_t slot = cursor[targets[e]]++;
+                    sources[slot] = static_cast<int>(u);
+                    inWeights[slot] = weights[e];
+                }
+            }
+        }
+    };
+
+    CompactGraph::CompactGraph()
+        : graphVersion(Graph::nextVersion()), offsets(EMPTY_OFFSETS), inOffsets(EMPTY_OFFSETS),
+          nameOffsets(EMPTY_OFFSETS) {}
+
+    CompactGraph::CompactGraph(const Graph& graph) : graphVersion(graph.getVersion()) {
+        const auto& nodes = graph.getAllNodes();
+        auto b = std::make_shared<Buffers>();
+
+        // Sort external IDs so dense order is deterministic
+        // and indexOf() can binary search instead of hashing
+        b->ids.reserve(nodes.size());
+        for (const auto& [id, node] : nodes) b->ids.push_back(id);
+        std::sort(b->ids.begin(), b->ids.end());
+
+        const size_t n = b->ids.size();
+        b->offsets.assign(n + 1, 0);
+        b->xs.resize(n);
+        b->ys.resize(n);
+        b->nameOffsets.assign(n + 1, 0);
+
+        // First pass: coords, names and edge counts
+        size_t edgeTotal = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const Node& node = nodes.at(b->ids[i]);
+            b->xs[i] = node.x;
+            b->ys[i] = node.y;
+            b->nameData.insert(b->nameData.end(), node.name.begin(), node.name.end());
+            b->nameOffsets[i + 1] = static_cast<uint32_t>(b->nameData.size());
+            edgeTotal += node.neighbors.size();
+        }
+
+        // indexOf() needs the sorted IDs in place
+        ids = b->ids.data();
+        nodeCount = n;
+
+        // Second pass: fill CSR arrays
+        b->targets.reserve(edgeTotal);
+        b->weights.reserve(edgeTotal);
+        for (size_t i = 0; i < n; ++i) {
+            for (const auto& edge : nodes.at(b->ids[i]).neighbors) {
+                int target = indexOf(edge.targetNodeID);
+                if (target == -1) continue; // Dangling edge
+                b->targets.push_back(target);
+                b->weights.push_back(edge.distance);
+            }
+            b->offsets[i + 1] = static_cast<uint32_t>(b->targets.size());
+        }
+
+        b->buildReverse();
+        adopt(std::move(b));
+    }
+
+    CompactGraph CompactGraph::permuted(const std::vector<int>& order) const {
+        const size_t n = nodeCount;
+        if (order.size() != n) throw std::invalid_argument("Node order must list every node once.");
+        std::vector<int> newIndex(n, -1);
+        for (size_t i = 0; i < n; ++i) {
+            if (order[i] < 0 || static_cast<size_t>(order[i]) >= n || newIndex[order[i]] != -1) {
+                throw std::invalid_argument("Node order must list every node once.");
+            }
+            newIndex[order[i]] = static_cast<int>(i);
+        }
+
+        auto b = std::make_shared<Buffers>();
+        b->ids.resize(n);
+        b->xs.resize(n);
+        b->ys.resize(n);
+        b->offsets.assign(n + 1, 0);
+        b->nameOffsets.assign(n + 1, 0);
+        b->targets.reserve(edgeCount);
+        b->weights.reserve(edgeCount);
+        b->nameData.reserve(nameOffsets[n]);
+        for (size_t i = 0; i < n; ++i) {
+            const int old = order[i];
+            b->ids[i] = ids[old];
+            b->xs[i] = xs[old];
+            b->ys[i] = ys[old];
+            b->nameData.insert(b->nameData.end(), nameData + nameOffsets[old], nameData + nameOffsets[old + 1]);
+            b->nameOffsets[i + 1] = static_cast<uint32_t>(b->nameData.size());
+            for (uint32_t e = offsets[old]; e < offsets[old + 1]; ++e) {
+                b->targets.push_back(newIndex[targets[e]]);
+                b->weights.push_back(weights[e]);
+            }
+            b->offsets[i + 1] = static_cast<uint32_t>(b->targets.size());
+        }
+        b->buildReverse();
+
+        // indexOf() goes through idOrder once IDs are out of order
+        if (!std::is_sorted(b->ids.begin(), b->ids.end())) {
+            b->idOrder.resize(n);
+            for (size_t i = 0; i < n; ++i) b->idOrder[i] = static_cast<int>(i);
+            std::sort(b->idOrder.begin(), b->idOrder.end(), [&](int a, int c) { return b->ids[a] < b->ids[c]; });
+        }
+
+        // Same nodes and weights, so the same version; dense indices moved, so a new layout
+        CompactGraph result;
+        result.adopt(std::move(b));
+        result.graphVersion = graphVersion;
+        result.graphLayout = result.idOrder ? permutedLayout(result.ids, n) : 0;
+        return result;
+    }
+
+    void CompactGraph::adopt(std::shared_ptr<Buffers> b) {
+        nodeCount = b->ids.size();
+        edgeCount = b->targets.size();
+        ids = b->ids.data();
+        offsets = b->offsets.data();
+        targets = b->targets.data();
+        weights = b->weights.data();
+        inOffsets = b->inOffsets.data();
+        sources = b->sources.data();
+        inWeights = b->inWeights.data();
+        xs = b->xs.data();
+        ys = b->ys.data();
+        nameOffsets = b->nameOffsets.data();
+        nameData = b->nameData.data();
+        idOrder = b->idOrder.empty() ? nullptr : b->idOrder.data();
+        storage = std::move(b);
+    }
+
+    CompactGraph CompactGraph::withWeights(const std::vector<WeightUpdate>& updates, size_t* applied) const {
+        struct WeightBuffers {
+            std::vector<double> weights;
+            std::vector<double> inWeights;
+        };
+        auto w = std::make_shared<WeightBuffers>();
+        w->weights.assign(weights, weights + edgeCount);
+        w->inWeights.assign(inWeights, inWeights + edgeCount);
+
+        size_t matched = 0;
+        for (const auto& update : updates) {
+            if (!(update.weight >= 0.0)) {
+                throw std::invalid_argument("Edge weight must be non-negative, got " + std::to_string(update.weight));
+            }
+            const int u = indexOf(update.from);
+            const int v = indexOf(update.to);
+            if (u == -1 || v == -1) continue;
+
+            // Forward and reverse copies of every parallel u -> v edge
+            bool found = false;
+            for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                if (targets[e] != v) continue;
+                w->weights[e] = update.weight;
+                found = true;
+            }
+            for (uint32_t e = inOffsets[v]; e < inOffsets[v + 1]; ++e) {
+                if (sources[e] == u) w->inWeights[e] = update.weight;
+            }
+            matched += found;
+        }
+        if (applied) *applied = matched;
+
+        // Topology, coords and names stay with the old storage
+        CompactGraph updated = *this;
+        updated.graphVersion = Graph::nextVersion();
+        updated.weights = w->weights.data();
+        updated.inWeights = w->inWeights.data();
+        updated.weightStorage = std::move(w);
+        return updated;
+    }
+
+    int CompactGraph::indexOf(int id) const {
+        if (idOrder) {
+            const int* end = idOrder + nodeCount;
+            const int* it = std::lower_bound(idOrder, end, id, [this](int index, int key) { return ids[index] < key; });
+            if (it != end && ids[*it] == id) return *it;
+            return -1;
+        }
+        const int* end = ids + nodeCount;
+        const int* it = std::lower_bound(ids, end, id);
+        if (it != end && *it == id) {
+            return static_cast<int>(it - ids);
+        }
+        return -1; // Not found
+    }
+
+    std::string_view CompactGraph::name(int index) const {
+        return std::string_view(nameData + nameOffsets[index], nameOffsets[index + 1] - nameOffsets[index]);
+    }
+
+    bool CompactGraph::save(const std::string& filepath) const {
+        const size_t n = nodeCount;
+        const SectionSource sections[] = {
+            section(SECTION_IDS, ids, n),
+            section(SECTION_OFFSETS, offsets, n + 1),
+            section(SECTION_TARGETS, targets, edgeCount),
+            section(SECTION_WEIGHTS, weights, edgeCount),
+            section(SECTION_IN_OFFSETS, inOffsets, n + 1),
+            section(SECTION_SOURCES, sources, edgeCount),
+            section(SECTION_IN_WEIGHTS, inWeights, edgeCount),
+            section(SECTION_XS, xs, n),
+            section(SECTION_YS, ys, n),
+            section(SECTION_NAME_OFFSETS, nameOffsets, n + 1),
+            section(SECTION_NAME_DATA, nameData, nameOffsets[n]),
+            section(SECTION_ID_ORDER, idOrder, idOrder ? n : 0),
+        };
+        const uint32_t sectionCount = sizeof(sections) / sizeof(sections[0]);
+
+        // Lay out the sections after the table
+        std::vector<SectionEntry> table(sectionCount);
+        size_t cursor = alignUp(sizeof(SnapshotHeader) + sectionCount * sizeof(SectionEntry));
+        for (uint32_t s = 0; s < sectionCount; ++s) {
+            table[s] = {sections[s].tag, sections[s].elementSize, static_cast<uint64_t>(cursor), sections[s].count};
+            cursor = alignUp(cursor + sections[s].count * sections[s].elementSize);
+        }
+
+        // Build the file in memory so the checksum covers exactly what is written
+        std::vector<char> body(cursor - sizeof(SnapshotHeader), 0);
+        std::memcpy(body.data(), table.data(), sectionCount * sizeof(SectionEntry));
+        for (uint32_t s = 0; s < sectionCount; ++s) {
+            size_t bytes = sections[s].count * sections[s].elementSize;
+            if (bytes > 0) std::memcpy(body.data() + table[s].offset - sizeof(SnapshotHeader), sections[s].data, bytes);
+        }
+
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        header.version = SNAPSHOT_VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.sectionCount = sectionCount;
+        header.nodeCount = n;
+        header.edgeCount = edgeCount;
+        header.fileSize = cursor;
+        header.checksum = checksum(body.data(), body.size());
+
+        std::ofstream file(filepath, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open snapshot file for writing: " << filepath << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(body.data(), body.size());
+        return static_cast<bool>(file);
+    }
+
+    bool CompactGraph::load(const std::string& filepath, CompactGraph& graph, bool verify) {
+        auto file = std::make_shared<MappedFile>();
+        // Searches jump around the arrays, so no read-ahead
+        if (!file->open(filepath, MappedFile::Access::Random)) {
+            std::cerr << "Error: Could not open snapshot file: " << filepath << std::endl;
+            return false;
+        }
+
+        const char* base = file->data();
+        SnapshotHeader header;
+        if (file->size() < sizeof(header)) {
+            std::cerr << "Error: Not a supported snapshot file: " << filepath << std::endl;
+            return false;
+        }
+        std::memcpy(&header, base, sizeof(header));
+        if (!std::equal(header.magic, header.magic + 4, SNAPSHOT_MAGIC)
+            || header.version < OLDEST_SNAPSHOT_VERSION || header.version > SNAPSHOT_VERSION
+            || header.byteOrder != BYTE_ORDER_MARK) {
+            std::cerr << "Error: Not a supported snapshot file: " << filepath << std::endl;
+            return false;
+        }
+
+        // Size checks first, so nothing below reads past the mapping
+        bool ok = header.fileSize == file->size()
+            && sizeof(header) + header.sectionCount * sizeof(SectionEntry) <= file->size();
+        const auto* table = reinterpret_cast<const SectionEntry*>(base + sizeof(header));
+        for (uint32_t s = 0; ok && s < header.sectionCount; ++s) {
+            const SectionEntry& entry = table[s];
+            ok = entry.offset % SECTION_ALIGNMENT == 0 && entry.offset <= file->size()
+                && entry.count <= (file->size() - entry.offset) / std::max<uint32_t>(1, entry.elementSize);
+        }
+        if (ok && verify) {
+            ok = checksum(base + sizeof(header), file->size() - sizeof(header)) == header.checksum;
+        }
+        if (!ok) {
+            std::cerr << "Error: Truncated or corrupt snapshot file: " << filepath << std::endl;
+            return false;
+        }
+
+        const uint64_t n = header.nodeCount;
+        const uint64_t m = header.edgeCount;
+        const uint32_t count = header.sectionCount;
+        CompactGraph loaded;
+        loaded.nodeCount = n;
+        loaded.edgeCount = m;
+        loaded.ids = findSection<int>(base, table, count, SECTION_IDS, n);
+        loaded.offsets = findSection<uint32_t>(base, table, count, SECTION_OFFSETS, n + 1);
+        loaded.targets = findSection<int>(base, table, count, SECTION_TARGETS, m);
+        loaded.weights = findSection<double>(base, table, count, SECTION_WEIGHTS, m);
+        loaded.inOffsets = findSection<uint32_t>(base, table, count, SECTION_IN_OFFSETS, n + 1);
+        loaded.sources = findSection<int>(base, table, count, SECTION_SOURCES, m);
+        loaded.inWeights = findSection<double>(base, table, count, SECTION_IN_WEIGHTS, m);
+        loaded.xs = findSection<double>(base, table, count, SECTION_XS, n);
+        loaded.ys = findSection<double>(base, table, count, SECTION_YS, n);
+        loaded.nameOffsets = findSection<uint32_t>(base, table, count, SECTION_NAME_OFFSETS, n + 1);
+        if (loaded.nameOffsets) {
+            loaded.nameData = findSection<char>(base, table, count, SECTION_NAME_DATA, loaded.nameOffsets[n]);
+        }
+        loaded.idOrder = n > 0 ? findSection<int>(base, table, count, SECTION_ID_ORDER, n) : nullptr;
+
+        // Every section present, and one O(n + m) pass over the structure: the checksum
+        // can be skipped, but a bad offset or index would make searches read out of bounds
+        ok = loaded.ids && loaded.offsets && loaded.targets && loaded.weights && loaded.inOffsets
+            && loaded.sources && loaded.inWeights && loaded.xs && loaded.ys && loaded.nameOffsets
+            && loaded.nameData && validOffsets(loaded.offsets, n, m) && validOffsets(loaded.inOffsets, n, m)
+            && validOffsets(loaded.nameOffsets, n, loaded.nameOffsets[n]) && validIndices(loaded.targets, m, n)
+            && validIndices(loaded.sources, m, n) && (!loaded.idOrder || validIndices(loaded.idOrder, n, n));
+        if (!ok) {
+            std::cerr << "Error: Snapshot is missing sections or inconsistent: " << filepath << std::endl;
+            return false;
+        }
+
+        loaded.graphLayout = loaded.idOrder ? permutedLayout(loaded.ids, n) : 0;
+        loaded.storage = std::move(file);
+        graph = std::move(loaded);
+        return true;
+    }
+}
@@ -0,0 +1,144 @@
+#include "route_planner/compressed_graph.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace RoutePlanner {
+    namespace {
+        // Largest finite code; the one above it means infinity
+        constexpr uint32_t MAX_CODE = std::numeric_limits<uint32_t>::max() - 1;
+
+        void appendVarint(std::vector<uint8_t>& out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        uint64_t zigzag(int64_t value) {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        void checkWeight(double weight) {
+            if (!(weight >= 0.0)) {
+                throw std::invalid_argument("Edge weight must be non-negative, got " + std::to_string(weight));
+            }
+        }
+    }
+
+    CompressedGraph::CompressedGraph(const CompactGraph& graph, double resolution) {
+        const size_t n = graph.numNodes();
+        edgeCount = graph.numEdges();
+        graphVersion = graph.version();
+        graphLayout = graph.layout();
+
+        ids.resize(n);
+        xs.assign(graph.xData(), graph.xData() + n);
+        ys.assign(graph.yData(), graph.yData() + n);
+        for (size_t i = 0; i < n; ++i) ids[i] = graph.idOf(static_cast<int>(i));
+        if (!std::is_sorted(ids.begin(), ids.end())) {
+            idOrder.resize(n);
+            for (size_t i = 0; i < n; ++i) idOrder[i] = static_cast<int>(i);
+            std::sort(idOrder.begin(), idOrder.end(), [this](int a, int b) { return ids[a] < ids[b]; });
+        }
+
+        double maxWeight = 0.0;
+        for (uint32_t e = 0; e < edgeCount; ++e) {
+            const double w = graph.weight(e);
+            checkWeight(w);
+            if (std::isfinite(w)) maxWeight = std::max(maxWeight, w);
+        }
+        if (!(resolution >= 0.0)) {
+            throw std::invalid_argument("Resolution must be non-negative, got " + std::to_string(resolution));
+        }
+        if (resolution == 0.0) {
+            resolution = maxWeight > 0.0 ? maxWeight / (MAX_CODE - 1) : 1.0; // One code of slack for rounding
+        } else if (maxWeight / resolution > MAX_CODE) {
+            throw std::invalid_argument("Resolution " + std::to_string(resolution) + " is too fine for weight "
+                                        + std::to_string(maxWeight));
+        }
+        unit = resolution;
+
+        auto encode = [this](double weight) {
+            if (!std::isfinite(weight)) return INFINITE_WEIGHT;
+            // Clamp while still a double; converting a quotient above UINT32_MAX is undefined
+            return static_cast<uint32_t>(std::min<double>(MAX_CODE, std::ceil(weight / unit)));
+        };
+
+        // (neighbour, code, direction) per entry of one node, reused across nodes
+        using Entry = std::tuple<int, uint32_t, uint32_t>;
+        std::vector<Entry> outs, ins, merged;
+
+        offsets.assign(n + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            const int u = static_cast<int>(i);
+            outs.clear();
+            ins.clear();
+            merged.clear();
+            for (uint32_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+                outs.emplace_back(graph.target(e), encode(graph.weight(e)), OUT);
+            }
+            for (uint32_t e = graph.inEdgeBegin(u); e < graph.inEdgeEnd(u); ++e) {
+                ins.emplace_back(graph.source(e), encode(graph.inWeight(e)), IN);
+            }
+            std::sort(outs.begin(), outs.end());
+            std::sort(ins.begin(), ins.end());
+
+            // Pair each out-edge with an in-edge from the same neighbour at the same (quantized) weight
+            size_t a = 0, b = 0;
+            while (a < outs.size() || b < ins.size()) {
+                if (b == ins.size()) {
+                    merged.push_back(outs[a++]);
+                } else if (a == outs.size()) {
+                    merged.push_back(ins[b++]);
+                } else {
+                    const auto& [outNeighbour, outCode, outDir] = outs[a];
+                    const auto& [inNeighbour, inCode, inDir] = ins[b];
+                    if (outNeighbour == inNeighbour && outCode == inCode) {
+                        merged.emplace_back(outNeighbour, outCode, OUT | IN);
+                        ++a;
+                        ++b;
+                    } else if (std::tie(outNeighbour, outCode) < std::tie(inNeighbour, inCode)) {
+                        merged.push_back(outs[a++]);
+                    } else {
+                        merged.push_back(ins[b++]);
+                    }
+                }
+            }
+
+            int64_t previous = u;
+            for (const auto& [neighbour, code, direction] : merged) {
+                appendVarint(data, zigzag(neighbour - previous) << 2 | direction);
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&code);
+                data.insert(data.end(), bytes, bytes + sizeof(code));
+                previous = neighbour;
+            }
+            if (data.size() > std::numeric_limits<uint32_t>::max()) {
+                throw std::length_error("Compressed edge streams exceed 4 GiB");
+            }
+            offsets[i + 1] = static_cast<uint32_t>(data.size());
+        }
+        data.shrink_to_fit();
+    }
+
+    int CompressedGraph::indexOf(int id) const {
+        if (!idOrder.empty()) {
+            auto it = std::lower_bound(idOrder.begin(), idOrder.end(), id,
+                                       [this](int index, int key) { return ids[index] < key; });
+            if (it != idOrder.end() && ids[*it] == id) return *it;
+            return -1;
+        }
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it != ids.end() && *it == id) return static_cast<int>(it - ids.begin());
+        return -1; // Not found
+    }
+
+    size_t CompressedGraph::bytesUsed() const {
+        return ids.capacity() * sizeof(int) + idOrder.capacity() * sizeof(int)
+            + (xs.capacity() + ys.capacity()) * sizeof(double) + offsets.capacity() * sizeof(uint32_t)
+            + data.capacity();
+    }
+}
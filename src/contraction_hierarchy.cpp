@@ -0,0 +1,495 @@
+#include "route_planner/contraction_hierarchy.hpp"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+
+namespace RoutePlanner {
+    namespace {
+        // Witness searches give up after this many settled nodes
+        // A missed witness only costs an extra shortcut, never correctness
+        // Priority estimates use a cheaper search than the real contraction
+        constexpr int SIMULATE_SETTLE_LIMIT = 50;
+        constexpr int CONTRACT_SETTLE_LIMIT = 500;
+
+        constexpr char FILE_MAGIC[4] = {'R', 'P', 'C', 'H'};
+        constexpr uint32_t FILE_VERSION = 1;
+
+        template <typename T>
+        void writeVector(std::ofstream& file, const std::vector<T>& data) {
+            file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+        }
+
+        template <typename T>
+        bool readVector(std::ifstream& file, std::vector<T>& data, uint64_t count) {
+            data.resize(count);
+            file.read(reinterpret_cast<char*>(data.data()), count * sizeof(T));
+            return static_cast<bool>(file);
+        }
+    }
+
+    ContractionHierarchy ContractionHierarchy::build(const CompactGraph& graph) {
+        const int n = static_cast<int>(graph.numNodes());
+
+        // Working graph, shrinks as nodes get contracted
+        // Only the cheapest arc per (u, v) pair is kept
+        std::vector<std::vector<Arc>> out(n), in(n);
+        auto addArc = [](std::vector<Arc>& list, int node, double weight, int middle) {
+            for (auto& arc : list) {
+                if (arc.node == node) {
+                    if (weight < arc.weight) arc = Arc{node, middle, weight};
+                    return;
+                }
+            }
+            list.push_back(Arc{node, middle, weight});
+        };
+        auto eraseArc = [](std::vector<Arc>& list, int node) {
+            list.erase(std::remove_if(list.begin(), list.end(),
+                [node](const Arc& arc) { return arc.node == node; }), list.end());
+        };
+
+        for (int u = 0; u < n; ++u) {
+            for (uint32_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+                int v = graph.target(e);
+                if (v == u) continue; // Self-loops never help a shortest path
+                addArc(out[u], v, graph.weight(e), -1);
+                addArc(in[v], u, graph.weight(e), -1);
+            }
+        }
+
+        // Local Dijkstra from 'source' avoiding 'skip', bounded by 'maxWeight'
+        // Stops early once every marked target is settled
+        SearchContext witness;
+        std::vector<uint32_t> targetMarks(n, 0);
+        uint32_t markStamp = 0;
+        auto witnessSearch = [&](int source, int skip, double maxWeight, int targetsLeft, int settleLimit) {
+            witness.reset(n);
+            auto& pq = witness.queue();
+            witness.update(source, 0.0, -1);
+            pq.push_back({0.0, source});
+
+            int settledCount = 0;
+            while (!pq.empty()) {
+                std::pop_heap(pq.begin(), pq.end(), std::greater<QueueEntry>());
+                QueueEntry current = pq.back();
+                pq.pop_back();
+
+                if (witness.settled(current.id)) continue;
+                if (current.key > maxWeight) break;
+                witness.settle(current.id);
+                if (++settledCount > settleLimit) break;
+                if (targetMarks[current.id] == markStamp && --targetsLeft == 0) break;
+
+                for (const auto& arc : out[current.id]) {
+                    if (arc.node == skip) continue;
+                    double d = current.key + arc.weight;
+                    if (d < witness.dist(arc.node)) {
+                        witness.update(arc.node, d, current.id);
+                        pq.push_back({d, arc.node});
+                        std::push_heap(pq.begin(), pq.end(), std::greater<QueueEntry>());
+                    }
+                }
+            }
+        };
+
+        // Count (simulate) or insert the shortcuts needed to remove 'v'
+        auto contract = [&](int v, bool simulate) {
+            int shortcuts = 0;
+            for (const auto& inArc : in[v]) {
+                const int u = inArc.node;
+
+                double maxWeight = -1.0;
+                int targets = 0;
+                ++markStamp;
+                for (const auto& outArc : out[v]) {
+                    if (outArc.node == u) continue;
+                    maxWeight = std::max(maxWeight, inArc.weight + outArc.weight);
+                    targetMarks[outArc.node] = markStamp;
+                    ++targets;
+                }
+                if (targets == 0) continue;
+
+                witnessSearch(u, v, maxWeight, targets, simulate ? SIMULATE_SETTLE_LIMIT : CONTRACT_SETTLE_LIMIT);
+
+                for (const auto& outArc : out[v]) {
+                    const int w = outArc.node;
+                    if (w == u) continue;
+                    double viaV = inArc.weight + outArc.weight;
+                    if (witness.dist(w) <= viaV) continue; // Witness path found
+
+                    ++shortcuts;
+                    if (!simulate) {
+                        addArc(out[u], w, viaV, v);
+                        addArc(in[w], u, viaV, v);
+                    }
+                }
+            }
+            return shortcuts;
+        };
+
+        // Importance: edge difference plus already contracted neighbours,
+        // which spreads contraction evenly over the map
+        std::vector<int> deletedNeighbors(n, 0);
+        std::vector<int> priority(n, 0);
+        auto computePriority = [&](int v) {
+            int edgeDifference = contract(v, true) - static_cast<int>(in[v].size() + out[v].size());
+            return edgeDifference + deletedNeighbors[v];
+        };
+
+        using Candidate = std::pair<int, int>; // (priority, node)
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> order;
+        for (int v = 0; v < n; ++v) {
+            priority[v] = computePriority(v);
+            order.push({priority[v], v});
+        }
+
+        ContractionHierarchy ch;
+        ch.ids.resize(n);
+        for (int i = 0; i < n; ++i) ch.ids[i] = graph.idOf(i);
+        ch.indexIds();
+        ch.ranks.assign(n, -1);
+
+        // Upward arcs of each node, captured when it is contracted
+        std::vector<std::vector<Arc>> upOut(n), upIn(n);
+        int nextRank = 0;
+
+        while (!order.empty()) {
+            auto [prio, v] = order.top();
+            order.pop();
+            auto isStale = [&](const Candidate& c) {
+                return ch.ranks[c.second] != -1 || c.first != priority[c.second];
+            };
+            if (isStale({prio, v})) continue;
+
+            // Lazy update: priorities drift as the graph changes
+            // Drop stale entries first so v is compared against a live candidate
+            while (!order.empty() && isStale(order.top())) order.pop();
+            int fresh = computePriority(v);
+            if (!order.empty() && fresh > order.top().first) {
+                priority[v] = fresh;
+                order.push({fresh, v});
+                continue;
+            }
+
+            contract(v, false);
+            ch.ranks[v] = nextRank++;
+
+            // Remaining neighbours all get contracted later, so these arcs point upward
+            upOut[v] = std::move(out[v]);
+            upIn[v] = std::move(in[v]);
+            out[v].clear();
+            in[v].clear();
+
+            std::vector<int> neighbors;
+            for (const auto& arc : upIn[v]) {
+                eraseArc(out[arc.node], v);
+                neighbors.push_back(arc.node);
+            }
+            for (const auto& arc : upOut[v]) {
+                eraseArc(in[arc.node], v);
+                neighbors.push_back(arc.node);
+            }
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+            for (int u : neighbors) {
+                ++deletedNeighbors[u];
+                priority[u] = computePriority(u);
+                order.push({priority[u], u});
+            }
+        }
+
+        // Flatten into CSR
+        auto flatten = [n](const std::vector<std::vector<Arc>>& lists, std::vector<uint32_t>& offsets, std::vector<Arc>& arcs) {
+            offsets.assign(n + 1, 0);
+            for (int v = 0; v < n; ++v) {
+                arcs.insert(arcs.end(), lists[v].begin(), lists[v].end());
+                offsets[v + 1] = static_cast<uint32_t>(arcs.size());
+            }
+        };
+        flatten(upOut, ch.forwardOffsets, ch.forwardArcs);
+        flatten(upIn, ch.backwardOffsets, ch.backwardArcs);
+
+        for (const auto& arc : ch.forwardArcs) ch.shortcutCount += (arc.middle != -1);
+        for (const auto& arc : ch.backwardArcs) ch.shortcutCount += (arc.middle != -1);
+
+        return ch;
+    }
+
+    RouteResult ContractionHierarchy::query(int startId, int endId, bool collectStats) const {
+        thread_local SearchContext forward;
+        thread_local SearchContext backward;
+        return query(startId, endId, forward, backward, collectStats);
+    }
+
+    RouteResult ContractionHierarchy::query(int startId, int endId, SearchContext& forward, SearchContext& backward,
+                                            bool collectStats) const {
+        return runWithStats(collectStats, "ch", [&](auto& recorder) {
+            return search(startId, endId, forward, backward, recorder);
+        });
+    }
+
+    template <typename Recorder>
+    RouteResult ContractionHierarchy::search(int startId, int endId, SearchContext& forward, SearchContext& backward,
+                                             Recorder& recorder) const {
+        recorder.beginPhase();
+        const size_t bytesBefore = forward.bytesReserved() + backward.bytesReserved();
+        const int start = indexOf(startId);
+        const int end = indexOf(endId);
+        if (start == -1 || end == -1) return endSetup(recorder, RouteResult{ {}, 0.0, false });
+
+        forward.reset(numNodes());
+        backward.reset(numNodes());
+        recorder.endPhase(&SearchStats::setupMicros);
+
+        recorder.beginPhase();
+        forward.update(start, 0.0, -1);
+        forward.queue().push_back({0.0, start});
+        recorder.push(1);
+        backward.update(end, 0.0, -1);
+        backward.queue().push_back({0.0, end});
+        recorder.push(1);
+
+        double best = std::numeric_limits<double>::infinity();
+        int meet = -1;
+
+        // Pop from whichever side has the smaller key
+        // A side is done once its smallest key can't beat the best meeting point
+        auto topKey = [](SearchContext& ctx) {
+            auto& pq = ctx.queue();
+            return pq.empty() ? std::numeric_limits<double>::infinity() : pq.front().key;
+        };
+
+        while (true) {
+            double forwardKey = topKey(forward);
+            double backwardKey = topKey(backward);
+            if (std::min(forwardKey, backwardKey) >= best) break;
+
+            bool isForward = forwardKey <= backwardKey;
+            SearchContext& self = isForward ? forward : backward;
+            SearchContext& other = isForward ? backward : forward;
+            const auto& offsets = isForward ? forwardOffsets : backwardOffsets;
+            const auto& arcs = isForward ? forwardArcs : backwardArcs;
+
+            auto& pq = self.queue();
+            std::pop_heap(pq.begin(), pq.end(), std::greater<QueueEntry>());
+            QueueEntry current = pq.back();
+            pq.pop_back();
+
+            if (self.settled(current.id)) {
+                recorder.stalePop();
+                continue;
+            }
+            self.settle(current.id);
+            recorder.settle();
+
+            if (other.reached(current.id)) {
+                double total = current.key + other.dist(current.id);
+                if (total < best) {
+                    best = total;
+                    meet = current.id;
+                }
+            }
+
+            // Stall-on-demand: if a higher node already reaches this one cheaper
+            // through the opposite arc set, the key is not a shortest distance,
+            // so expanding it can only produce useless entries
+            const auto& oppositeOffsets = isForward ? backwardOffsets : forwardOffsets;
+            const auto& oppositeArcs = isForward ? backwardArcs : forwardArcs;
+            bool stalled = false;
+            for (uint32_t a = oppositeOffsets[current.id]; a < oppositeOffsets[current.id + 1]; ++a) {
+                const Arc& arc = oppositeArcs[a];
+                if (self.reached(arc.node) && self.dist(arc.node) + arc.weight < current.key) {
+                    stalled = true;
+                    break;
+                }
+            }
+            if (stalled) continue;
+
+            for (uint32_t a = offsets[current.id]; a < offsets[current.id + 1]; ++a) {
+                recorder.relax();
+                const Arc& arc = arcs[a];
+                double d = current.key + arc.weight;
+                if (d < self.dist(arc.node)) {
+                    self.update(arc.node, d, current.id);
+                    pq.push_back({d, arc.node});
+                    std::push_heap(pq.begin(), pq.end(), std::greater<QueueEntry>());
+                    recorder.push(pq.size());
+                }
+            }
+        }
+        recorder.endPhase(&SearchStats::searchMicros);
+        recorder.allocated(forward.bytesReserved() + backward.bytesReserved() - bytesBefore);
+
+        RouteResult result;
+        if (meet == -1) {
+            result.success = false;
+            result.totalDist = 0.0;
+            return result;
+        }
+
+        recorder.beginPhase();
+        // Hierarchy-level path: start -> meet (forward tree), meet -> end (backward tree)
+        std::vector<int> upPath;
+        for (int curr = meet; curr != -1; curr = forward.parent(curr)) upPath.push_back(curr);
+        std::reverse(upPath.begin(), upPath.end());
+        for (int curr = backward.parent(meet); curr != -1; curr = backward.parent(curr)) upPath.push_back(curr);
+
+        // Expand shortcuts back into original edges
+        std::vector<int> dense{upPath.front()};
+        for (size_t i = 0; i + 1 < upPath.size(); ++i) unpack(upPath[i], upPath[i + 1], dense);
+
+        result.success = true;
+        result.totalDist = best;
+        result.path.reserve(dense.size());
+        for (int v : dense) result.path.push_back(ids[v]);
+        recorder.endPhase(&SearchStats::pathMicros);
+        recorder.allocated((upPath.capacity() + dense.capacity() + result.path.capacity()) * sizeof(int));
+        return result;
+    }
+
+    const ContractionHierarchy::Arc* ContractionHierarchy::findArc(int from, int to) const {
+        // Arc lives with whichever endpoint was contracted first
+        if (ranks[from] < ranks[to]) {
+            for (uint32_t a = forwardOffsets[from]; a < forwardOffsets[from + 1]; ++a) {
+                if (forwardArcs[a].node == to) return &forwardArcs[a];
+            }
+        } else {
+            for (uint32_t a = backwardOffsets[to]; a < backwardOffsets[to + 1]; ++a) {
+                if (backwardArcs[a].node == from) return &backwardArcs[a];
+            }
+        }
+        return nullptr;
+    }
+
+    void ContractionHierarchy::unpack(int from, int to, std::vector<int>& out) const {
+        // Explicit stack, shortcut nesting can get deep
+        std::vector<std::pair<int, int>> stack{{from, to}};
+        while (!stack.empty()) {
+            auto [u, w] = stack.back();
+            stack.pop_back();
+
+            const Arc* arc = findArc(u, w);
+            if (!arc || arc->middle == -1) {
+                out.push_back(w);
+            } else {
+                // Push second half first so the first half is expanded first
+                stack.push_back({arc->middle, w});
+                stack.push_back({u, arc->middle});
+            }
+        }
+    }
+
+    void ContractionHierarchy::indexIds() {
+        idOrder.clear();
+        if (std::is_sorted(ids.begin(), ids.end())) return;
+        idOrder.resize(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) idOrder[i] = static_cast<int>(i);
+        std::sort(idOrder.begin(), idOrder.end(), [this](int a, int b) { return ids[a] < ids[b]; });
+    }
+
+    int ContractionHierarchy::indexOf(int id) const {
+        if (!idOrder.empty()) {
+            auto it = std::lower_bound(idOrder.begin(), idOrder.end(), id,
+                                       [this](int index, int key) { return ids[index] < key; });
+            return it != idOrder.end() && ids[*it] == id ? *it : -1;
+        }
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it != ids.end() && *it == id) {
+            return static_cast<int>(it - ids.begin());
+        }
+        return -1; // Not found
+    }
+
+    int ContractionHierarchy::rankOf(int id) const {
+        int index = indexOf(id);
+        return index == -1 ? -1 : ranks[index];
+    }
+
+    bool ContractionHierarchy::save(const std::string& filepath) const {
+        std::ofstream file(filepath, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open hierarchy file for writing: " << filepath << std::endl;
+            return false;
+        }
+
+        // Header: magic, version, then sizes of each array
+        uint64_t sizes[4] = {ids.size(), forwardArcs.size(), backwardArcs.size(), shortcutCount};
+        file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+        file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+
+        writeVector(file, ids);
+        writeVector(file, ranks);
+        writeVector(file, forwardOffsets);
+        writeVector(file, forwardArcs);
+        writeVector(file, backwardOffsets);
+        writeVector(file, backwardArcs);
+
+        return static_cast<bool>(file);
+    }
+
+    bool ContractionHierarchy::load(const std::string& filepath, ContractionHierarchy& ch) {
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open hierarchy file: " << filepath << std::endl;
+            return false;
+        }
+        const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        char magic[4];
+        uint32_t version = 0;
+        uint64_t sizes[4];
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+        if (!file || !std::equal(magic, magic + 4, FILE_MAGIC) || version != FILE_VERSION) {
+            std::cerr << "Error: Not a supported hierarchy file: " << filepath << std::endl;
+            return false;
+        }
+
+        // Sizes must add up to the file length before anything is allocated from them
+        const uint64_t n = sizes[0];
+        bool ok = n < INT32_MAX && sizes[1] <= fileSize / sizeof(Arc) && sizes[2] <= fileSize / sizeof(Arc)
+            && sizeof(FILE_MAGIC) + sizeof(FILE_VERSION) + sizeof(sizes) + 2 * n * sizeof(int)
+                + 2 * (n + 1) * sizeof(uint32_t) + (sizes[1] + sizes[2]) * sizeof(Arc) == fileSize;
+
+        ContractionHierarchy loaded;
+        ok = ok && readVector(file, loaded.ids, n)
+            && readVector(file, loaded.ranks, n)
+            && readVector(file, loaded.forwardOffsets, n + 1)
+            && readVector(file, loaded.forwardArcs, sizes[1])
+            && readVector(file, loaded.backwardOffsets, n + 1)
+            && readVector(file, loaded.backwardArcs, sizes[2]);
+
+        // Offsets start at 0, never decrease and end at the arc counts; every index is a node
+        auto inRange = [n](int v) { return v >= 0 && static_cast<uint64_t>(v) < n; };
+        auto validOffsets = [n](const std::vector<uint32_t>& offsets, uint64_t total) {
+            if (offsets[0] != 0 || offsets[n] != total) return false;
+            for (uint64_t i = 0; i < n; ++i) {
+                if (offsets[i] > offsets[i + 1]) return false;
+            }
+            return true;
+        };
+        auto validArcs = [&](const std::vector<Arc>& arcs) {
+            return std::all_of(arcs.begin(), arcs.end(), [&](const Arc& arc) {
+                return inRange(arc.node) && (arc.middle == -1 || inRange(arc.middle));
+            });
+        };
+        ok = ok && validOffsets(loaded.forwardOffsets, sizes[1]) && validOffsets(loaded.backwardOffsets, sizes[2])
+            && validArcs(loaded.forwardArcs) && validArcs(loaded.backwardArcs)
+            && std::all_of(loaded.ranks.begin(), loaded.ranks.end(), inRange);
+        if (!ok) {
+            std::cerr << "Error: Truncated or corrupt hierarchy file: " << filepath << std::endl;
+            return false;
+        }
+
+        loaded.shortcutCount = sizes[3];
+        loaded.indexIds();
+        ch = std::move(loaded);
+        return true;
+    }
+}
@@ -0,0 +1,105 @@
+#include "route_planner/distance_kernels.hpp"
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ROUTE_PLANNER_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace RoutePlanner {
+    namespace {
+        using Kernel = void (*)(const double*, const double*, const int*, size_t, double, double, double*);
+
+        template <bool Squared>
+        void scalarKernel(const double* xs, const double* ys, const int* nodes, size_t count, double x, double y,
+                          double* out) {
+            for (size_t i = 0; i < count; ++i) {
+                const double dx = xs[nodes[i]] - x;
+                const double dy = ys[nodes[i]] - y;
+                const double squared = dx * dx + dy * dy;
+                out[i] = Squared ? squared : std::sqrt(squared);
+            }
+        }
+
+#ifdef ROUTE_PLANNER_HAVE_AVX2
+        // Four nodes per step: gather coordinates by index, then the same ops as the scalar loop
+        // Built for AVX2 on its own, the rest of the library keeps the baseline target
+        template <bool Squared>
+        __attribute__((target("avx2"))) void avx2Kernel(const double* xs, const double* ys, const int* nodes,
+                                                        size_t count, double x, double y, double* out) {
+            const __m256d px = _mm256_set1_pd(x);
+            const __m256d py = _mm256_set1_pd(y);
+            // Masked form with every lane on; the unmasked one trips -Wmaybe-uninitialized on GCC 12
+            const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            const __m256d zero = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nodes + i));
+                const __m256d dx = _mm256_sub_pd(_mm256_mask_i32gather_pd(zero, xs, index, all, 8), px);
+                const __m256d dy = _mm256_sub_pd(_mm256_mask_i32gather_pd(zero, ys, index, all, 8), py);
+                // Separate mul and add, an FMA would round differently from the scalar kernel
+                const __m256d squared = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+                _mm256_storeu_pd(out + i, Squared ? squared : _mm256_sqrt_pd(squared));
+            }
+            scalarKernel<Squared>(xs, ys, nodes + i, count - i, x, y, out + i);
+        }
+
+        bool cpuHasAvx2() {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        }
+#endif
+
+        KernelIsa detect() {
+#ifdef ROUTE_PLANNER_HAVE_AVX2
+            if (cpuHasAvx2()) return KernelIsa::Avx2;
+#endif
+            return KernelIsa::Scalar;
+        }
+
+        template <bool Squared>
+        Kernel kernelFor(KernelIsa isa) {
+#ifdef ROUTE_PLANNER_HAVE_AVX2
+            if (isa == KernelIsa::Avx2 && DistanceKernels::active() == KernelIsa::Avx2) return avx2Kernel<Squared>;
+#endif
+            (void)isa;
+            return scalarKernel<Squared>;
+        }
+
+        // Resolved on first use, afterwards one indirect call per batch
+        Kernel activeEuclidean() {
+            static const Kernel kernel = kernelFor<false>(DistanceKernels::active());
+            return kernel;
+        }
+
+        Kernel activeSquaredEuclidean() {
+            static const Kernel kernel = kernelFor<true>(DistanceKernels::active());
+            return kernel;
+        }
+    }
+
+    KernelIsa DistanceKernels::active() {
+        static const KernelIsa isa = detect();
+        return isa;
+    }
+
+    void DistanceKernels::euclidean(const double* xs, const double* ys, const int* nodes, size_t count, double x,
+                                    double y, double* out) {
+        activeEuclidean()(xs, ys, nodes, count, x, y, out);
+    }
+
+    void DistanceKernels::squaredEuclidean(const double* xs, const double* ys, const int* nodes, size_t count,
+                                           double x, double y, double* out) {
+        activeSquaredEuclidean()(xs, ys, nodes, count, x, y, out);
+    }
+
+    void DistanceKernels::euclidean(KernelIsa isa, const double* xs, const double* ys, const int* nodes, size_t count,
+                                    double x, double y, double* out) {
+        kernelFor<false>(isa)(xs, ys, nodes, count, x, y, out);
+    }
+
+    void DistanceKernels::squaredEuclidean(KernelIsa isa, const double* xs, const double* ys, const int* nodes,
+                                           size_t count, double x, double y, double* out) {
+        kernelFor<true>(isa)(xs, ys, nodes, count, x, y, out);
+    }
+}
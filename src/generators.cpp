@@ -0,0 +1,147 @@
+#include "route_planner/generators.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace RoutePlanner {
+    namespace {
+        constexpr double PI = 3.14159265358979323846;
+
+        // mt19937_64 output is fully specified by the standard, the distributions are not
+        class Rng {
+        public:
+            explicit Rng(unsigned seed) : engine(seed) {}
+
+            // Uniform in [0, 1)
+            double uniform() { return (engine() >> 11) * 0x1.0p-53; }
+
+            // Uniform in [0, n), tiny modulo bias is fine here
+            size_t below(size_t n) { return engine() % n; }
+
+        private:
+            std::mt19937_64 engine;
+        };
+
+        // Two-way road, weight at least the straight-line distance
+        void addRoad(Graph& graph, int u, int v, double length, Rng& rng) {
+            double weight = length * (1.0 + 0.5 * rng.uniform());
+            graph.addEdge(u, v, weight);
+            graph.addEdge(v, u, weight);
+        }
+
+        void addNodes(Graph& graph, size_t count, const std::vector<double>& xs, const std::vector<double>& ys) {
+            graph.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                int id = static_cast<int>(i) + 1;
+                graph.addNode(id, "n" + std::to_string(id), xs[i], ys[i]);
+            }
+        }
+    }
+
+    Graph Generators::grid(size_t width, size_t height, unsigned seed) {
+        Rng rng(seed);
+        Graph graph;
+        const size_t n = width * height;
+        std::vector<double> xs(n), ys(n);
+        for (size_t i = 0; i < n; ++i) {
+            xs[i] = static_cast<double>(i % width);
+            ys[i] = static_cast<double>(i / width);
+        }
+        addNodes(graph, n, xs, ys);
+
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                int id = static_cast<int>(y * width + x) + 1;
+                if (x + 1 < width) addRoad(graph, id, id + 1, 1.0, rng);
+                if (y + 1 < height) addRoad(graph, id, id + static_cast<int>(width), 1.0, rng);
+            }
+        }
+        return graph;
+    }
+
+    Graph Generators::randomGeometric(size_t numNodes, double averageDegree, unsigned seed) {
+        Rng rng(seed);
+        Graph graph;
+        const double side = std::sqrt(static_cast<double>(numNodes));
+        std::vector<double> xs(numNodes), ys(numNodes);
+        for (size_t i = 0; i < numNodes; ++i) {
+            xs[i] = rng.uniform() * side;
+            ys[i] = rng.uniform() * side;
+        }
+        addNodes(graph, numNodes, xs, ys);
+        if (numNodes == 0) return graph;
+
+        // Density 1, so pi * r^2 = expected neighbours
+        const double radius = std::sqrt(averageDegree / PI);
+
+        // Bucket points into radius-sized cells; neighbours are in the 3x3 block around a cell
+        const size_t cells = std::max<size_t>(1, static_cast<size_t>(side / radius));
+        const double cellSize = side / cells;
+        auto cellOf = [&](double v) { return std::min(cells - 1, static_cast<size_t>(v / cellSize)); };
+        std::vector<std::vector<int>> buckets(cells * cells);
+        for (size_t i = 0; i < numNodes; ++i) {
+            buckets[cellOf(ys[i]) * cells + cellOf(xs[i])].push_back(static_cast<int>(i));
+        }
+
+        for (size_t i = 0; i < numNodes; ++i) {
+            size_t cx = cellOf(xs[i]), cy = cellOf(ys[i]);
+            for (size_t by = (cy == 0 ? 0 : cy - 1); by <= std::min(cells - 1, cy + 1); ++by) {
+                for (size_t bx = (cx == 0 ? 0 : cx - 1); bx <= std::min(cells - 1, cx + 1); ++bx) {
+                    for (int j : buckets[by * cells + bx]) {
+                        if (j <= static_cast<int>(i)) continue; // Each pair once
+                        double length = std::hypot(xs[i] - xs[j], ys[i] - ys[j]);
+                        if (length <= radius) addRoad(graph, static_cast<int>(i) + 1, j + 1, length, rng);
+                    }
+                }
+            }
+        }
+        return graph;
+    }
+
+    Graph Generators::scaleFree(size_t numNodes, size_t edgesPerNode, unsigned seed) {
+        Rng rng(seed);
+        Graph graph;
+        const double side = std::sqrt(static_cast<double>(numNodes));
+        std::vector<double> xs(numNodes), ys(numNodes);
+        for (size_t i = 0; i < numNodes; ++i) {
+            xs[i] = rng.uniform() * side;
+            ys[i] = rng.uniform() * side;
+        }
+        addNodes(graph, numNodes, xs, ys);
+
+        auto link = [&](size_t u, size_t v) {
+            addRoad(graph, static_cast<int>(u) + 1, static_cast<int>(v) + 1,
+                    std::hypot(xs[u] - xs[v], ys[u] - ys[v]), rng);
+        };
+
+        // Seed with a small clique, then attach the rest
+        // 'endpoints' lists every node once per incident edge, so a uniform
+        // pick from it is a degree-proportional pick
+        const size_t core = std::min(numNodes, edgesPerNode + 1);
+        std::vector<size_t> endpoints;
+        endpoints.reserve(2 * numNodes * edgesPerNode);
+        for (size_t u = 0; u < core; ++u) {
+            for (size_t v = u + 1; v < core; ++v) {
+                link(u, v);
+                endpoints.push_back(u);
+                endpoints.push_back(v);
+            }
+        }
+
+        std::vector<size_t> picked;
+        for (size_t u = core; u < numNodes; ++u) {
+            picked.clear();
+            while (picked.size() < edgesPerNode) {
+                size_t v = endpoints[rng.below(endpoints.size())];
+                if (std::find(picked.begin(), picked.end(), v) == picked.end()) picked.push_back(v);
+            }
+            for (size_t v : picked) {
+                link(u, v);
+                endpoints.push_back(u);
+                endpoints.push_back(v);
+            }
+        }
+        return graph;
+    }
+}
@@ -1,11 +1,37 @@
 #include "route_planner/graph.hpp"
+#include "route_planner/compact_graph.hpp"
+#include <algorithm>
+#include <atomic>
 #include <stdexcept>
 
 namespace RoutePlanner {
+    Graph::Graph() : version(nextVersion()) {}
+
+    uint64_t Graph::nextVersion() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
     void Graph::addNode(int id, const std::string& name, double x, double y) {
         // Use ID as key to insert new Node
         // If ID already exists, this will overwrite it
+        auto it = nodes.find(id);
+        if (it != nodes.end()) {
+            // Drop the old name from the index first
+            auto& oldIds = idsByName[it->second.name];
+            oldIds.erase(std::lower_bound(oldIds.begin(), oldIds.end(), id));
+            if (oldIds.empty()) idsByName.erase(it->second.name);
+        }
         nodes[id] = Node{id, name, x, y, {}};
+
+        auto& ids = idsByName[name];
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+        version = nextVersion();
+    }
+
+    void Graph::reserve(size_t nodeCount) {
+        nodes.reserve(nodeCount);
+        idsByName.reserve(nodeCount);
     }
 
     void Graph::addEdge(int u, int v, double weight) {
@@ -18,6 +44,7 @@ namespace RoutePlanner {
         if (it != nodes.end()) {
             // it->second refers to Node object assoc with ID
             it->second.neighbors.push_back(Edge{v, weight});
+            version = nextVersion();
         } else {
             // throw exception to be caught elsewhere
             throw std::runtime_error("Source node " + std::to_string(u) + " not found.");
@@ -25,8 +52,9 @@ namespace RoutePlanner {
     }
 
     int Graph::findIdByName(const std::string& name) const {
-        for (const auto& [id, node] : nodes) {
-            if (node.name == name) return id;
+        auto it = idsByName.find(name);
+        if (it != idsByName.end()) {
+            return it->second.front(); // Smallest ID wins
         }
         return -1; // Not found
     }
@@ -44,4 +72,8 @@ namespace RoutePlanner {
     const std::unordered_map<int, Node>& Graph::getAllNodes() const {
         return nodes;
     }
+
+    CompactGraph Graph::freeze() const {
+        return CompactGraph(*this);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "route_planner/hub_labels.hpp"
+#include "route_planner/search_context.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace RoutePlanner {
+    namespace {
+        constexpr char FILE_MAGIC[4] = {'R', 'P', 'H', 'L'};
+        constexpr uint32_t FILE_VERSION = 1;
+
+        template <typename T>
+        void writeVector(std::ofstream& file, const std::vector<T>& data) {
+            file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+        }
+
+        template <typename T>
+        bool readVector(std::ifstream& file, std::vector<T>& data, uint64_t count) {
+            data.resize(count);
+            file.read(reinterpret_cast<char*>(data.data()), count * sizeof(T));
+            return static_cast<bool>(file);
+        }
+
+        // Every entry in [low, n)
+        bool inRange(const std::vector<int>& values, int low, uint64_t n) {
+            return std::all_of(values.begin(), values.end(),
+                               [&](int v) { return v >= low && static_cast<int64_t>(v) < static_cast<int64_t>(n); });
+        }
+
+        // Label entry while building, flattened into the SoA arrays at the end
+        struct Entry {
+            uint32_t hub;
+            double dist;
+            int parent;
+        };
+    }
+
+    HubLabels HubLabels::build(const Graph& graph) {
+        return build(graph.freeze());
+    }
+
+    HubLabels HubLabels::build(const CompactGraph& graph) {
+        return build(graph, ContractionHierarchy::build(graph));
+    }
+
+    HubLabels HubLabels::build(const CompactGraph& graph, const ContractionHierarchy& hierarchy) {
+        const int n = static_cast<int>(graph.numNodes());
+        const double infinity = std::numeric_limits<double>::infinity();
+
+        HubLabels labels;
+        labels.ids.resize(n);
+        for (int i = 0; i < n; ++i) labels.ids[i] = graph.idOf(i);
+        labels.indexIds();
+
+        // Most important (contracted last) first
+        std::vector<int> ranks(n);
+        for (int i = 0; i < n; ++i) {
+            ranks[i] = hierarchy.rankOf(labels.ids[i]);
+            if (ranks[i] == -1 || hierarchy.numNodes() != graph.numNodes()) {
+                throw std::invalid_argument("Hierarchy was not built on this graph.");
+            }
+        }
+        labels.hubNodes.resize(n);
+        for (int i = 0; i < n; ++i) labels.hubNodes[i] = i;
+        std::sort(labels.hubNodes.begin(), labels.hubNodes.end(), [&](int a, int b) { return ranks[a] > ranks[b]; });
+
+        // Pruned Dijkstra from each hub in turn, forward (filling in-labels) then
+        // backward (filling out-labels). A node whose distance the labels built
+        // so far already give is skipped along with everything behind it
+        std::vector<std::vector<Entry>> outLabels(n), inLabels(n);
+        std::vector<double> rootDist(n, infinity); // Hub order -> distance, the root's own label
+        SearchContext context;
+        auto prunedSearch = [&](uint32_t hub, bool forward) {
+            const int root = labels.hubNodes[hub];
+            const auto& rootLabel = forward ? outLabels[root] : inLabels[root];
+            auto& reached = forward ? inLabels : outLabels;
+            for (const auto& entry : rootLabel) rootDist[entry.hub] = entry.dist;
+
+            context.reset(n);
+            BinaryHeap pq(context.queue());
+            context.update(root, 0.0, -1);
+            pq.push(root, 0.0);
+            while (!pq.empty()) {
+                QueueEntry current = pq.pop();
+                if (context.settled(current.id)) continue;
+                context.settle(current.id);
+
+                double known = infinity;
+                for (const auto& entry : reached[current.id]) known = std::min(known, rootDist[entry.hub] + entry.dist);
+                if (known <= current.key) continue; // A more important hub covers it
+                reached[current.id].push_back({hub, current.key, context.parent(current.id)});
+
+                auto relax = [&](int next, double weight) {
+                    const double d = current.key + weight;
+                    if (d < context.dist(next)) {
+                        context.update(next, d, current.id);
+                        pq.push(next, d);
+                    }
+                };
+                if (forward) {
+                    for (uint32_t e = graph.edgeBegin(current.id); e < graph.edgeEnd(current.id); ++e) {
+                        relax(graph.target(e), graph.weight(e));
+                    }
+                } else {
+                    for (uint32_t e = graph.inEdgeBegin(current.id); e < graph.inEdgeEnd(current.id); ++e) {
+                        relax(graph.source(e), graph.inWeight(e));
+                    }
+                }
+            }
+            for (const auto& entry : rootLabel) rootDist[entry.hub] = infinity;
+        };
+        for (uint32_t hub = 0; hub < static_cast<uint32_t>(n); ++hub) {
+            prunedSearch(hub, true);
+            prunedSearch(hub, false);
+        }
+
+        // Entries were appended in hub order, so every label is already sorted
+        auto flatten = [n](std::vector<std::vector<Entry>>& source, Labels& target) {
+            target.offsets.assign(n + 1, 0);
+            for (int i = 0; i < n; ++i) {
+                for (const auto& entry : source[i]) {
+                    target.hubs.push_back(entry.hub);
+                    target.dists.push_back(entry.dist);
+                    target.parents.push_back(entry.parent);
+                }
+                target.hubs.push_back(SENTINEL);
+                target.dists.push_back(std::numeric_limits<double>::infinity());
+                target.parents.push_back(-1);
+                target.offsets[i + 1] = static_cast<uint32_t>(target.hubs.size());
+                std::vector<Entry>().swap(source[i]); // Free as we go, labels can be large
+            }
+        };
+        flatten(outLabels, labels.out);
+        flatten(inLabels, labels.in);
+        return labels;
+    }
+
+    double HubLabels::intersect(int s, int t, uint32_t& hub) const {
+        const uint32_t* outHubs = out.hubs.data();
+        const uint32_t* inHubs = in.hubs.data();
+        const double* outDists = out.dists.data();
+        const double* inDists = in.dists.data();
+
+        double best = std::numeric_limits<double>::infinity();
+        hub = SENTINEL;
+        uint32_t i = out.offsets[s];
+        uint32_t j = in.offsets[t];
+        // Both labels end in SENTINEL, so this stops exactly when both are used up
+        while (true) {
+            const uint32_t a = outHubs[i];
+            const uint32_t b = inHubs[j];
+            if (a == b) {
+                if (a == SENTINEL) break;
+                const double d = outDists[i] + inDists[j];
+                if (d < best) {
+                    best = d;
+                    hub = a;
+                }
+            }
+            i += a <= b;
+            j += b <= a;
+        }
+        return best;
+    }
+
+    uint32_t HubLabels::findEntry(const Labels& labels, int node, uint32_t hub) const {
+        auto begin = labels.hubs.begin() + labels.offsets[node];
+        auto end = labels.hubs.begin() + labels.offsets[node + 1] - 1; // Sentinel excluded
+        return static_cast<uint32_t>(std::lower_bound(begin, end, hub) - labels.hubs.begin());
+    }
+
+    double HubLabels::distance(int startId, int endId) const {
+        const int s = indexOf(startId);
+        const int t = indexOf(endId);
+        if (s == -1 || t == -1) return std::numeric_limits<double>::infinity();
+        uint32_t hub;
+        return intersect(s, t, hub);
+    }
+
+    RouteResult HubLabels::query(int startId, int endId) const {
+        const int s = indexOf(startId);
+        const int t = indexOf(endId);
+        if (s == -1 || t == -1) return { {}, 0.0, false };
+
+        uint32_t hub;
+        const double best = intersect(s, t, hub);
+        if (hub == SENTINEL) return { {}, 0.0, false };
+
+        // s -> hub along out-label parents, then hub -> t along in-label parents (collected backwards)
+        // Every node on either chain was labelled by the same pruned search, so it holds 'hub' too
+        RouteResult result;
+        result.success = true;
+        result.totalDist = best;
+        // A chain that leaves the hub's entries, or runs longer than the graph, means corrupt labels
+        const int hubNode = hubNodes[hub];
+        auto walk = [&](const Labels& labels, int v, int stop) {
+            for (size_t steps = 0; v != stop; ++steps) {
+                if (v < 0) return false;
+                const uint32_t entry = findEntry(labels, v, hub);
+                if (labels.hubs[entry] != hub || steps > ids.size()) return false;
+                result.path.push_back(ids[v]);
+                v = labels.parents[entry];
+            }
+            return true;
+        };
+        if (!walk(out, s, hubNode)) return { {}, 0.0, false };
+        const size_t middle = result.path.size();
+        if (!walk(in, t, -1)) return { {}, 0.0, false };
+        std::reverse(result.path.begin() + middle, result.path.end());
+        return result;
+    }
+
+    size_t HubLabels::numEntries() const {
+        return out.hubs.size() + in.hubs.size() - 2 * ids.size();
+    }
+
+    size_t HubLabels::bytesUsed() const {
+        size_t bytes = (ids.capacity() + idOrder.capacity() + hubNodes.capacity()) * sizeof(int);
+        for (const Labels* labels : {&out, &in}) {
+            bytes += (labels->offsets.capacity() + labels->hubs.capacity()) * sizeof(uint32_t)
+                + labels->dists.capacity() * sizeof(double) + labels->parents.capacity() * sizeof(int);
+        }
+        return bytes;
+    }
+
+    void HubLabels::indexIds() {
+        idOrder.clear();
+        if (std::is_sorted(ids.begin(), ids.end())) return;
+        idOrder.resize(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) idOrder[i] = static_cast<int>(i);
+        std::sort(idOrder.begin(), idOrder.end(), [this](int a, int b) { return ids[a] < ids[b]; });
+    }
+
+    int HubLabels::indexOf(int id) const {
+        if (!idOrder.empty()) {
+            auto it = std::lower_bound(idOrder.begin(), idOrder.end(), id,
+                                       [this](int index, int key) { return ids[index] < key; });
+            return it != idOrder.end() && ids[*it] == id ? *it : -1;
+        }
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it != ids.end() && *it == id) {
+            return static_cast<int>(it - ids.begin());
+        }
+        return -1; // Not found
+    }
+
+    bool HubLabels::save(const std::string& filepath) const {
+        std::ofstream file(filepath, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open hub label file for writing: " << filepath << std::endl;
+            return false;
+        }
+
+        // Header: magic, version, then sizes of each array
+        uint64_t sizes[3] = {ids.size(), out.hubs.size(), in.hubs.size()};
+        file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+        file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+
+        writeVector(file, ids);
+        writeVector(file, hubNodes);
+        for (const Labels* labels : {&out, &in}) {
+            writeVector(file, labels->offsets);
+            writeVector(file, labels->hubs);
+            writeVector(file, labels->dists);
+            writeVector(file, labels->parents);
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    bool HubLabels::load(const std::string& filepath, HubLabels& labels) {
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open hub label file: " << filepath << std::endl;
+            return false;
+        }
+        const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        char magic[4];
+        uint32_t version = 0;
+        uint64_t sizes[3];
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+        if (!file || !std::equal(magic, magic + 4, FILE_MAGIC) || version != FILE_VERSION) {
+            std::cerr << "Error: Not a supported hub label file: " << filepath << std::endl;
+            return false;
+        }
+
+        // Sizes must add up to the file length before anything is allocated from them
+        const uint64_t n = sizes[0];
+        const uint64_t entryBytes = sizeof(uint32_t) + sizeof(double) + sizeof(int);
+        bool ok = n < INT32_MAX && sizes[1] <= fileSize / entryBytes && sizes[2] <= fileSize / entryBytes
+            && sizeof(FILE_MAGIC) + sizeof(FILE_VERSION) + sizeof(sizes) + 2 * n * sizeof(int)
+                + 2 * (n + 1) * sizeof(uint32_t) + (sizes[1] + sizes[2]) * entryBytes == fileSize;
+
+        HubLabels loaded;
+        ok = ok && readVector(file, loaded.ids, n) && readVector(file, loaded.hubNodes, n)
+            && inRange(loaded.hubNodes, 0, n);
+        Labels* directions[2] = {&loaded.out, &loaded.in};
+        for (int d = 0; d < 2 && ok; ++d) {
+            Labels& l = *directions[d];
+            ok = readVector(file, l.offsets, n + 1) && readVector(file, l.hubs, sizes[1 + d])
+                && readVector(file, l.dists, sizes[1 + d]) && readVector(file, l.parents, sizes[1 + d])
+                && l.offsets[0] == 0 && l.offsets[n] == sizes[1 + d] && inRange(l.parents, -1, n);
+            // Each label non-empty, hubs strictly ascending and valid, ending in the sentinel the merge stops at
+            for (uint64_t i = 0; i < n && ok; ++i) {
+                ok = l.offsets[i] < l.offsets[i + 1] && l.offsets[i + 1] <= sizes[1 + d]
+                    && l.hubs[l.offsets[i + 1] - 1] == SENTINEL;
+                for (uint32_t k = l.offsets[i]; ok && k + 1 < l.offsets[i + 1]; ++k) {
+                    ok = l.hubs[k] < l.hubs[k + 1] && l.hubs[k] < n;
+                }
+            }
+        }
+        if (!ok) {
+            std::cerr << "Error: Truncated or corrupt hub label file: " << filepath << std::endl;
+            return false;
+        }
+
+        loaded.indexIds();
+        labels = std::move(loaded);
+        return true;
+    }
+}
@@ -0,0 +1,181 @@
+#include "route_planner/landmarks.hpp"
+#include "route_planner/search_context.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+
+namespace RoutePlanner {
+    namespace {
+        constexpr double INF = std::numeric_limits<double>::infinity();
+
+        // Full Dijkstra from 'source', over out-edges or (backward) in-edges
+        // Settled nodes are appended to 'order' in order of distance
+        void dijkstra(const CompactGraph& graph, int source, bool backward, SearchContext& ctx, std::vector<int>& order) {
+            const uint32_t* offsets = backward ? graph.inOffsetData() : graph.offsetData();
+            const int* heads = backward ? graph.sourceData() : graph.targetData();
+            const double* weights = backward ? graph.inWeightData() : graph.weightData();
+
+            ctx.reset(graph.numNodes());
+            order.clear();
+            auto& pq = ctx.queue();
+            ctx.update(source, 0.0, -1);
+            pq.push_back({0.0, source});
+
+            while (!pq.empty()) {
+                std::pop_heap(pq.begin(), pq.end(), std::greater<QueueEntry>());
+                QueueEntry current = pq.back();
+                pq.pop_back();
+
+                if (ctx.settled(current.id)) continue;
+                ctx.settle(current.id);
+                order.push_back(current.id);
+
+                for (uint32_t e = offsets[current.id]; e < offsets[current.id + 1]; ++e) {
+                    double d = current.key + weights[e];
+                    if (d < ctx.dist(heads[e])) {
+                        ctx.update(heads[e], d, current.id);
+                        pq.push_back({d, heads[e]});
+                        std::push_heap(pq.begin(), pq.end(), std::greater<QueueEntry>());
+                    }
+                }
+            }
+        }
+    }
+
+    Landmarks Landmarks::select(const CompactGraph& graph, size_t count, LandmarkStrategy strategy, unsigned seed) {
+        Landmarks result;
+        const size_t n = graph.numNodes();
+        result.nodeCount = n;
+        result.graphLayout = graph.layout();
+        result.graphVersion = graph.version();
+        count = std::min(count, n);
+        if (count == 0) return result;
+
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> pickNode(0, static_cast<int>(n) - 1);
+        SearchContext ctx;
+        std::vector<int> order;
+
+        // Landmark-major while selecting, transposed at the end
+        std::vector<std::vector<double>> fromColumns, toColumns;
+        auto addLandmark = [&](int landmark) {
+            result.landmarks.push_back(landmark);
+
+            dijkstra(graph, landmark, false, ctx, order);
+            fromColumns.emplace_back(n);
+            for (size_t v = 0; v < n; ++v) fromColumns.back()[v] = ctx.dist(static_cast<int>(v));
+
+            dijkstra(graph, landmark, true, ctx, order);
+            toColumns.emplace_back(n);
+            for (size_t v = 0; v < n; ++v) toColumns.back()[v] = ctx.dist(static_cast<int>(v));
+        };
+        auto isLandmark = [&](int v) {
+            return std::find(result.landmarks.begin(), result.landmarks.end(), v) != result.landmarks.end();
+        };
+
+        // First landmark: farthest node from a random root, i.e. on the map's rim
+        {
+            int root = pickNode(rng);
+            dijkstra(graph, root, false, ctx, order);
+            addLandmark(order.back());
+        }
+
+        std::vector<double> minDist(n);
+        std::vector<double> subtreeSize(n);
+        std::vector<int> bestChild(n);
+
+        while (result.landmarks.size() < count) {
+            int next = -1;
+
+            if (strategy == LandmarkStrategy::Farthest) {
+                // Maximise distance to the nearest landmark so far
+                // Nodes no landmark reaches count as infinitely far (new component)
+                std::fill(minDist.begin(), minDist.end(), INF);
+                for (const auto& column : fromColumns) {
+                    for (size_t v = 0; v < n; ++v) minDist[v] = std::min(minDist[v], column[v]);
+                }
+                double farthest = -1.0;
+                for (size_t v = 0; v < n; ++v) {
+                    int node = static_cast<int>(v);
+                    if (minDist[v] > farthest && !isLandmark(node)) {
+                        farthest = minDist[v];
+                        next = node;
+                    }
+                }
+            } else {
+                // Avoid: grow a shortest-path tree from a random root and weight each node
+                // by how badly current landmarks bound d(root, v). Walk down the heaviest
+                // subtree that holds no landmark and take the leaf
+                int root = pickNode(rng);
+                dijkstra(graph, root, false, ctx, order);
+
+                for (int v : order) {
+                    double bound = 0.0;
+                    for (size_t i = 0; i < fromColumns.size(); ++i) {
+                        double a = fromColumns[i][v] - fromColumns[i][root];
+                        double b = toColumns[i][root] - toColumns[i][v];
+                        if (a > bound) bound = a;
+                        if (b > bound) bound = b;
+                    }
+                    subtreeSize[v] = std::max(0.0, ctx.dist(v) - bound);
+                    bestChild[v] = -1;
+                }
+
+                // Children finish before parents in reverse settle order
+                for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                    int v = *it;
+                    if (isLandmark(v)) subtreeSize[v] = -INF; // Poison whole subtree
+                    int parent = ctx.parent(v);
+                    if (parent == -1) continue;
+                    if (bestChild[parent] == -1 || subtreeSize[v] > subtreeSize[bestChild[parent]]) {
+                        bestChild[parent] = v;
+                    }
+                    subtreeSize[parent] += subtreeSize[v];
+                }
+
+                next = root;
+                while (bestChild[next] != -1 && subtreeSize[bestChild[next]] > 0.0) next = bestChild[next];
+                if (next == root || isLandmark(next)) next = -1;
+            }
+
+            // Everything covered: fall back to any unused node
+            if (next == -1) {
+                do {
+                    next = pickNode(rng);
+                } while (isLandmark(next));
+            }
+            addLandmark(next);
+        }
+
+        // Node-major layout for the query hot path
+        const size_t k = result.landmarks.size();
+        result.fromLandmark.resize(n * k);
+        result.toLandmark.resize(n * k);
+        for (size_t v = 0; v < n; ++v) {
+            for (size_t i = 0; i < k; ++i) {
+                result.fromLandmark[v * k + i] = fromColumns[i][v];
+                result.toLandmark[v * k + i] = toColumns[i][v];
+            }
+        }
+        return result;
+    }
+
+    double Landmarks::lowerBound(int from, int to) const {
+        const size_t k = landmarks.size();
+        const double* fromV = &fromLandmark[from * k];
+        const double* fromT = &fromLandmark[to * k];
+        const double* toV = &toLandmark[from * k];
+        const double* toT = &toLandmark[to * k];
+
+        // NaN (inf - inf) compares false and is skipped
+        double best = 0.0;
+        for (size_t i = 0; i < k; ++i) {
+            double a = fromT[i] - fromV[i]; // d(L, to) - d(L, from)
+            double b = toV[i] - toT[i]; // d(from, L) - d(to, L)
+            if (a > best) best = a;
+            if (b > best) best = b;
+        }
+        return best;
+    }
+}
@@ -0,0 +1,27 @@
+#include "route_planner/live_graph.hpp"
+
+namespace RoutePlanner {
+    LiveGraph::LiveGraph(CompactGraph graph)
+        : current(std::make_shared<const CompactGraph>(std::move(graph))) {}
+
+    std::shared_ptr<const CompactGraph> LiveGraph::snapshot() const {
+        return std::atomic_load(&current);
+    }
+
+    size_t LiveGraph::applyUpdates(const std::vector<WeightUpdate>& updates) {
+        // One writer at a time, otherwise two batches built from the same base
+        // would each drop the other's changes
+        std::lock_guard<std::mutex> lock(writer);
+        size_t applied = 0;
+        auto next = std::make_shared<const CompactGraph>(snapshot()->withWeights(updates, &applied));
+
+        // The old version is freed when its last reader drops it
+        std::atomic_store(&current, std::shared_ptr<const CompactGraph>(std::move(next)));
+        return applied;
+    }
+
+    RouteResult LiveGraph::computePath(int startId, int endId, const RouteOptions& options) const {
+        std::shared_ptr<const CompactGraph> graph = snapshot();
+        return Router::computePath(*graph, startId, endId, options);
+    }
+}
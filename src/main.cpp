@@ -1,12 +1,17 @@
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <charconv> // std::from_chars
 #include <chrono>
 #include <iomanip>
+#include <filesystem>
 #include <SFML/Graphics.hpp>
 #include "route_planner/utility.hpp"
 #include "route_planner/graph.hpp"
+#include "route_planner/compact_graph.hpp"
 #include "route_planner/map_loader.hpp"
 #include "route_planner/router.hpp"
+#include "route_planner/route_server.hpp"
 #include "route_planner/visualizer.hpp"
 
 // Not using namespace "RoutePlanner"
@@ -38,10 +43,61 @@ int drawSFMLMap() {
 }
 
 
-int main() {
-    RoutePlanner::Graph myMap;
+int main(int argc, char* argv[]) {
+    // --snapshot <file>: map the binary snapshot if it exists, otherwise build it from the CSVs
+    // --serve: answer route requests on stdin/stdout instead of opening the GUI (see route_server.hpp)
+    // --workers <n>: routing threads for --serve, default one per core
+    std::string snapshotPath;
+    bool serve = false;
+    RoutePlanner::ServerOptions serverOptions;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool valid = true;
+        if (arg == "--snapshot" && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else if (arg == "--serve") {
+            serve = true;
+        } else if (arg == "--workers" && i + 1 < argc) {
+            // Whole argument must be a positive count; from_chars rejects signs and trailing junk
+            std::string_view value = argv[++i];
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), serverOptions.workers);
+            valid = ec == std::errc() && end == value.data() + value.size() && serverOptions.workers > 0;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            std::cerr << "Usage: " << argv[0] << " [--snapshot <file>] [--serve [--workers <n>]]" << std::endl;
+            return 1;
+        }
+    }
 
-    std::cout << "--- Route Planner Initializing ---" << std::endl;
+    // stdout carries the protocol in server mode, so progress goes to stderr
+    std::ostream& log = serve ? std::cerr : std::cout;
+
+    // Hand the loaded map to the GUI or the server
+    auto run = [&](const RoutePlanner::CompactGraph& compact) {
+        if (serve) {
+            std::ios::sync_with_stdio(false); // Lets the server batch whatever stdin has buffered
+            log << "Serving requests on stdin..." << std::endl;
+            size_t answered = RoutePlanner::RouteServer::serve(compact, std::cin, std::cout, serverOptions);
+            log << "Answered " << answered << " requests." << std::endl;
+            return 0;
+        }
+        log << "Opening GUI..." << std::endl;
+        RoutePlanner::displaySFML(compact); // GUI takes over control here
+        return 0;
+    };
+
+    log << "--- Route Planner Initializing ---" << std::endl;
+
+    RoutePlanner::CompactGraph compact;
+    if (!snapshotPath.empty() && std::filesystem::exists(snapshotPath)
+        && RoutePlanner::CompactGraph::load(snapshotPath, compact)) {
+        log << "Snapshot Loaded." << std::endl;
+        return run(compact);
+    }
+
+    RoutePlanner::Graph myMap;
 
     // Attempt to load nodes
     if (!RoutePlanner::MapLoader::loadNodes("data/nodes.csv", myMap)) {
@@ -58,10 +114,13 @@ int main() {
         }
     }
 
-    std::cout << "Map Loaded. Opening GUI..." << std::endl;
-    RoutePlanner::displaySFML(myMap); // GUI takes over control here
-    
-    return 0;
+    compact = myMap.freeze();
+    if (!snapshotPath.empty() && compact.save(snapshotPath)) {
+        log << "Snapshot written to " << snapshotPath << std::endl;
+    }
+
+    log << "Map Loaded." << std::endl;
+    return run(compact);
 }
 // int main() {
 //     RoutePlanner::Graph myMap;
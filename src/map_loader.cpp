@@ -1,82 +1,232 @@
 #include "route_planner/map_loader.hpp"
+#include "route_planner/mapped_file.hpp"
+#include "route_planner/thread_pool.hpp"
 #include "route_planner/utility.hpp"
-#include <fstream> // File stream
-#include <sstream> // String stream
+#include <algorithm>
+#include <charconv> // std::from_chars
+#include <cmath>
 #include <iostream> // For debugging
+#include <string_view>
 
 namespace RoutePlanner {
-    bool MapLoader::loadNodes(const std::string& filepath, Graph& graph) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
-            std::cerr << "Error: Could not open nodes file: " << filepath << std::endl;
-            return false;
-        }
+    namespace {
+        // Below this much text per chunk, threading costs more than it saves
+        constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
 
-        std::string line;
-        while (std::getline(file, line)) {
-            // Skip comments or empty lines
-            if (line.empty() || line[0] == '#') continue;
+        // Without an error sink, only this many bad lines are printed
+        constexpr size_t MAX_PRINTED_ERRORS = 10;
 
-            // std::stringstream acts like a buffer
-            // Feed line into it, then extrat data piece by piece
-            std::stringstream ss(line);
-            std::string item;
+        // Parsed value plus the line it came from
+        template <typename T>
+        struct Parsed {
+            T value;
+            size_t line;
+        };
 
+        template <typename T>
+        struct Chunk {
+            std::string_view text;
+            size_t lineCount = 0;
+            std::vector<Parsed<T>> records;
+            std::vector<ParseError> errors;
+        };
+
+        struct NodeRecord {
             int id;
             std::string name;
             double x, y;
+        };
+
+        struct EdgeRecord {
+            int u, v;
+            double distance;
+        };
+
+        std::string_view trim(std::string_view s) {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+            return s;
+        }
 
-            // Parsing: ID, Name, X, Y
-            // std::getline(ss, item, ',') reads until next comma
-            try {
-                std::getline(ss, item, ','); id = std::stoi(item);
-                std::getline(ss, name, ','); 
-                std::getline(ss, item, ','); x = std::stod(item);
-                std::getline(ss, item, ','); y = std::stod(item);
-
-                graph.addNode(id, toLower(name), x, y);
-            } catch(...) {
-                // '...' catches all exceptions
-                continue;
+        // Pop the next comma-separated field off 'rest'
+        bool nextField(std::string_view& rest, std::string_view& field) {
+            if (rest.data() == nullptr) return false; // No fields left
+            size_t comma = rest.find(',');
+            field = rest.substr(0, comma);
+            rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+            return true;
+        }
+
+        // Whole (trimmed) field must be a number, unlike std::stoi which stops at junk
+        template <typename T>
+        bool parseNumber(std::string_view field, T& value) {
+            field = trim(field);
+            if (field.empty()) return false;
+            auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+            return ec == std::errc() && end == field.data() + field.size();
+        }
+
+        // Cut 'data' into pieces that each start at a line boundary
+        std::vector<std::string_view> splitChunks(std::string_view data, size_t maxChunks) {
+            size_t count = std::max<size_t>(1, std::min(maxChunks, data.size() / MIN_CHUNK_BYTES));
+            std::vector<std::string_view> pieces;
+            size_t start = 0;
+            for (size_t i = 1; i <= count && start < data.size(); ++i) {
+                size_t end = data.size();
+                if (i < count) {
+                    end = data.find('\n', std::max(start, data.size() / count * i));
+                    end = (end == std::string_view::npos) ? data.size() : end + 1;
+                }
+                pieces.push_back(data.substr(start, end - start));
+                start = end;
+            }
+            return pieces;
+        }
+
+        // Parse every line of 'data' with parseLine(line, record, error) on the shared pool
+        // Comment (#) and empty lines are skipped. Line numbers come back file-relative
+        template <typename T, typename ParseLine>
+        std::vector<Chunk<T>> parseParallel(std::string_view data, ParseLine parseLine) {
+            ThreadPool& pool = ThreadPool::shared();
+            std::vector<Chunk<T>> chunks;
+            for (auto piece : splitChunks(data, pool.size() * 4)) {
+                chunks.emplace_back();
+                chunks.back().text = piece;
+            }
+
+            pool.parallelFor(chunks.size(), [&](size_t c) {
+                Chunk<T>& chunk = chunks[c];
+                std::string_view rest = chunk.text;
+                std::string error;
+                while (!rest.empty()) {
+                    size_t newline = rest.find('\n');
+                    std::string_view line = rest.substr(0, newline);
+                    rest = newline == std::string_view::npos ? std::string_view() : rest.substr(newline + 1);
+                    ++chunk.lineCount;
+
+                    // Skip comments or empty lines
+                    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                    if (line.empty() || line[0] == '#') continue;
+
+                    T record;
+                    if (parseLine(line, record, error)) {
+                        chunk.records.push_back({std::move(record), chunk.lineCount});
+                    } else {
+                        chunk.errors.push_back({chunk.lineCount, error});
+                    }
+                }
+            });
+
+            // Chunk-local line numbers -> file line numbers
+            size_t firstLine = 0;
+            for (auto& chunk : chunks) {
+                for (auto& record : chunk.records) record.line += firstLine;
+                for (auto& error : chunk.errors) error.line += firstLine;
+                firstLine += chunk.lineCount;
+            }
+            return chunks;
+        }
+
+        // Hand errors to the caller, or print a few so they are not silently lost
+        void reportErrors(const std::string& filepath, std::vector<ParseError>& found, std::vector<ParseError>* errors) {
+            std::sort(found.begin(), found.end(),
+                      [](const ParseError& a, const ParseError& b) { return a.line < b.line; });
+            if (errors) {
+                errors->insert(errors->end(), found.begin(), found.end());
+                return;
+            }
+            for (size_t i = 0; i < found.size() && i < MAX_PRINTED_ERRORS; ++i) {
+                std::cerr << "Warning: " << filepath << ":" << found[i].line << ": " << found[i].message << std::endl;
+            }
+            if (found.size() > MAX_PRINTED_ERRORS) {
+                std::cerr << "Warning: " << filepath << ": " << (found.size() - MAX_PRINTED_ERRORS)
+                          << " more malformed lines skipped" << std::endl;
             }
         }
-        return true;
     }
 
-    bool MapLoader::loadEdges(const std::string& filepath, Graph& graph) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
-            std::cerr << "Error: Could not open edges file: " << filepath << std::endl;
+    bool MapLoader::loadNodes(const std::string& filepath, Graph& graph, std::vector<ParseError>* errors) {
+        MappedFile file;
+        if (!file.open(filepath)) {
+            std::cerr << "Error: Could not open nodes file: " << filepath << std::endl;
             return false;
         }
 
-        std::string line;
-        while (std::getline(file, line)) {
-            // Skip comments or empty lines
-            if (line.empty() || line[0] == '#') continue;
+        // Parsing: ID, Name, X, Y
+        auto chunks = parseParallel<NodeRecord>(file.view(), [](std::string_view line, NodeRecord& node, std::string& error) {
+            std::string_view id, name, x, y;
+            if (!nextField(line, id) || !nextField(line, name) || !nextField(line, x) || !nextField(line, y)) {
+                error = "expected 'id, name, x, y'";
+                return false;
+            }
+            if (!parseNumber(id, node.id)) { error = "bad node id '" + std::string(id) + "'"; return false; }
+            if (!parseNumber(x, node.x)) { error = "bad x coordinate '" + std::string(x) + "'"; return false; }
+            if (!parseNumber(y, node.y)) { error = "bad y coordinate '" + std::string(y) + "'"; return false; }
+            node.name = toLower(std::string(trim(name)));
+            return true;
+        });
 
-            // std::stringstream acts like a buffer
-            // Feed line into it, then extrat data piece by piece
-            std::stringstream ss(line);
-            std::string item;
+        // Merge in file order, so a repeated ID keeps its last definition as before
+        size_t total = 0;
+        std::vector<ParseError> found;
+        for (const auto& chunk : chunks) {
+            total += chunk.records.size();
+            found.insert(found.end(), chunk.errors.begin(), chunk.errors.end());
+        }
+        graph.reserve(graph.getAllNodes().size() + total);
+        for (auto& chunk : chunks) {
+            for (auto& parsed : chunk.records) {
+                NodeRecord& node = parsed.value;
+                graph.addNode(node.id, node.name, node.x, node.y);
+            }
+        }
 
-            int u, v;
-            double distance;
+        reportErrors(filepath, found, errors);
+        return true;
+    }
+
+    bool MapLoader::loadEdges(const std::string& filepath, Graph& graph, std::vector<ParseError>* errors) {
+        MappedFile file;
+        if (!file.open(filepath)) {
+            std::cerr << "Error: Could not open edges file: " << filepath << std::endl;
+            return false;
+        }
 
-            // Parsing: U, V, Distance
-            // std::getline(ss, item, ',') reads until next comma
-            try {
-                std::getline(ss, item, ','); u = std::stoi(item);
-                std::getline(ss, item, ','); v = std::stoi(item);
-                std::getline(ss, item, ','); distance = std::stod(item);
-
-                graph.addEdge(u, v, distance);
-                graph.addEdge(v, u, distance); // Bidirectional road;
-            } catch(...) {
-                // '...' catches all exceptions
-                continue;
+        // Parsing: U, V, Distance
+        auto chunks = parseParallel<EdgeRecord>(file.view(), [](std::string_view line, EdgeRecord& edge, std::string& error) {
+            std::string_view u, v, distance;
+            if (!nextField(line, u) || !nextField(line, v) || !nextField(line, distance)) {
+                error = "expected 'u, v, distance'";
+                return false;
             }
+            if (!parseNumber(u, edge.u)) { error = "bad start node id '" + std::string(u) + "'"; return false; }
+            if (!parseNumber(v, edge.v)) { error = "bad end node id '" + std::string(v) + "'"; return false; }
+            if (!parseNumber(distance, edge.distance) || !std::isfinite(edge.distance) || edge.distance < 0.0) {
+                error = "bad distance '" + std::string(distance) + "'";
+                return false;
+            }
+            return true;
+        });
+
+        std::vector<ParseError> found;
+        for (const auto& chunk : chunks) {
+            found.insert(found.end(), chunk.errors.begin(), chunk.errors.end());
         }
+        for (const auto& chunk : chunks) {
+            for (const auto& parsed : chunk.records) {
+                const EdgeRecord& edge = parsed.value;
+                // Check both ends first so a bad line never leaves half a road behind
+                if (!graph.getNode(edge.u) || !graph.getNode(edge.v)) {
+                    int missing = graph.getNode(edge.u) ? edge.v : edge.u;
+                    found.push_back({parsed.line, "unknown node id " + std::to_string(missing)});
+                    continue;
+                }
+                graph.addEdge(edge.u, edge.v, edge.distance);
+                graph.addEdge(edge.v, edge.u, edge.distance); // Bidirectional road;
+            }
+        }
+
+        reportErrors(filepath, found, errors);
         return true;
     }
-}
\ No newline at end of file
+}
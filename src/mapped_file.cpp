@@ -0,0 +1,94 @@
+#include "route_planner/mapped_file.hpp"
+#include <fstream>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RoutePlanner {
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            buffer = std::move(other.buffer);
+            begin = other.mapped ? other.begin : buffer.data();
+            length = other.length;
+            opened = other.opened;
+            mapped = other.mapped;
+            other.begin = nullptr;
+            other.length = 0;
+            other.opened = false;
+            other.mapped = false;
+        }
+        return *this;
+    }
+
+    bool MappedFile::open(const std::string& filepath, Access access) {
+        close();
+
+#ifndef _WIN32
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* region = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (region != MAP_FAILED) {
+                ::madvise(region, length, access == Access::Random ? MADV_RANDOM : MADV_SEQUENTIAL);
+                begin = static_cast<const char*>(region);
+                mapped = true;
+            }
+        }
+        ::close(fd); // Mapping stays valid after close
+
+        if (mapped || length == 0) {
+            opened = true;
+            return true;
+        }
+        // mmap refused (e.g. special file), fall through to a plain read
+#endif
+
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        length = static_cast<size_t>(file.tellg());
+        buffer.resize(length);
+        file.seekg(0);
+        file.read(buffer.data(), length);
+        if (!file) {
+            close();
+            return false;
+        }
+        begin = buffer.data();
+        opened = true;
+        return true;
+    }
+
+    void MappedFile::close() {
+#ifndef _WIN32
+        if (mapped) ::munmap(const_cast<char*>(begin), length);
+#endif
+        buffer.clear();
+        buffer.shrink_to_fit();
+        begin = nullptr;
+        length = 0;
+        opened = false;
+        mapped = false;
+    }
+}
@@ -0,0 +1,61 @@
+#include "route_planner/name_index.hpp"
+#include <algorithm>
+
+namespace RoutePlanner {
+    NameIndex::NameIndex(const CompactGraph& graph) : graph(graph) {
+        const int n = static_cast<int>(graph.numNodes());
+        sorted.resize(n);
+        for (int i = 0; i < n; ++i) sorted[i] = i;
+
+        // Name ties by external ID: dense order need not be ID order on a permuted graph
+        std::sort(sorted.begin(), sorted.end(), [&](int a, int b) {
+            const std::string_view nameA = graph.name(a);
+            const std::string_view nameB = graph.name(b);
+            return nameA != nameB ? nameA < nameB : graph.idOf(a) < graph.idOf(b);
+        });
+
+        ranges.reserve(n);
+        for (uint32_t i = 0; i < sorted.size();) {
+            std::string_view name = graph.name(sorted[i]);
+            uint32_t end = i + 1;
+            while (end < sorted.size() && graph.name(sorted[end]) == name) ++end;
+            ranges.emplace(name, Range{i, end - i});
+            i = end;
+        }
+    }
+
+    int NameIndex::find(std::string_view name) const {
+        auto it = ranges.find(name);
+        if (it == ranges.end()) return -1; // Not found
+        return graph.idOf(sorted[it->second.first]);
+    }
+
+    std::vector<int> NameIndex::findAll(std::string_view name) const {
+        std::vector<int> result;
+        auto it = ranges.find(name);
+        if (it == ranges.end()) return result;
+        for (uint32_t i = 0; i < it->second.count; ++i) {
+            result.push_back(graph.idOf(sorted[it->second.first + i]));
+        }
+        return result;
+    }
+
+    std::vector<NameMatch> NameIndex::complete(std::string_view prefix, size_t k) const {
+        std::vector<NameMatch> result;
+
+        // First name >= prefix; everything sharing the prefix follows it contiguously
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), prefix, [&](int index, std::string_view key) {
+            return graph.name(index) < key;
+        });
+
+        size_t i = it - sorted.begin();
+        while (i < sorted.size() && result.size() < k) {
+            std::string_view name = graph.name(sorted[i]);
+            if (name.substr(0, prefix.size()) != prefix) break;
+            const Range& range = ranges.at(name);
+            result.push_back({name, graph.idOf(sorted[i]), range.count});
+            i += range.count; // Skip duplicates
+        }
+        return result;
+    }
+}
@@ -0,0 +1,109 @@
+#include "route_planner/node_order.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace RoutePlanner {
+    namespace {
+        // Position of (x, y) along a Hilbert curve filling a 2^16 x 2^16 grid
+        uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+            constexpr uint32_t SIDE = 1u << 16;
+            uint64_t d = 0;
+            for (uint32_t s = SIDE / 2; s > 0; s /= 2) {
+                uint32_t rx = (x & s) ? 1 : 0;
+                uint32_t ry = (y & s) ? 1 : 0;
+                d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+                // Rotate the quadrant so the curve stays continuous
+                if (ry == 0) {
+                    if (rx == 1) {
+                        x = SIDE - 1 - x;
+                        y = SIDE - 1 - y;
+                    }
+                    std::swap(x, y);
+                }
+            }
+            return d;
+        }
+
+        std::vector<int> hilbertOrder(const CompactGraph& graph) {
+            const size_t n = graph.numNodes();
+            std::vector<int> order(n);
+            std::iota(order.begin(), order.end(), 0);
+            if (n == 0) return order;
+
+            const double* xs = graph.xData();
+            const double* ys = graph.yData();
+            auto [minX, maxX] = std::minmax_element(xs, xs + n);
+            auto [minY, maxY] = std::minmax_element(ys, ys + n);
+            // Same scale on both axes keeps the curve's cells square
+            const double span = std::max(*maxX - *minX, *maxY - *minY);
+            const double scale = span > 0.0 ? 65535.0 / span : 0.0;
+
+            std::vector<uint64_t> keys(n);
+            for (size_t i = 0; i < n; ++i) {
+                keys[i] = hilbertIndex(static_cast<uint32_t>((xs[i] - *minX) * scale),
+                                       static_cast<uint32_t>((ys[i] - *minY) * scale));
+            }
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+            return order;
+        }
+
+        // BFS over out- and in-edges from each unvisited root in turn
+        // With 'byDegree', roots and each node's newly found neighbours go lowest degree first
+        std::vector<int> breadthFirstOrder(const CompactGraph& graph, bool byDegree) {
+            const int n = static_cast<int>(graph.numNodes());
+            auto degree = [&](int v) { return graph.degree(v) + (graph.inEdgeEnd(v) - graph.inEdgeBegin(v)); };
+
+            std::vector<int> roots(n);
+            std::iota(roots.begin(), roots.end(), 0);
+            if (byDegree) {
+                std::stable_sort(roots.begin(), roots.end(), [&](int a, int b) { return degree(a) < degree(b); });
+            }
+
+            std::vector<int> order;
+            order.reserve(n);
+            std::vector<char> visited(n, 0);
+            for (int root : roots) {
+                if (visited[root]) continue;
+                visited[root] = 1;
+                order.push_back(root);
+                // 'order' doubles as the queue
+                for (size_t head = order.size() - 1; head < order.size(); ++head) {
+                    const int u = order[head];
+                    const size_t firstNew = order.size();
+                    auto visit = [&](int v) {
+                        if (visited[v]) return;
+                        visited[v] = 1;
+                        order.push_back(v);
+                    };
+                    for (uint32_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) visit(graph.target(e));
+                    for (uint32_t e = graph.inEdgeBegin(u); e < graph.inEdgeEnd(u); ++e) visit(graph.source(e));
+                    if (byDegree) {
+                        std::stable_sort(order.begin() + firstNew, order.end(),
+                                         [&](int a, int b) { return degree(a) < degree(b); });
+                    }
+                }
+            }
+            return order;
+        }
+    }
+
+    std::vector<int> NodeOrdering::compute(const CompactGraph& graph, NodeOrder order) {
+        switch (order) {
+            case NodeOrder::BreadthFirst:
+                return breadthFirstOrder(graph, false);
+            case NodeOrder::CuthillMcKee: {
+                std::vector<int> result = breadthFirstOrder(graph, true);
+                std::reverse(result.begin(), result.end());
+                return result;
+            }
+            case NodeOrder::Hilbert:
+            default:
+                return hilbertOrder(graph);
+        }
+    }
+
+    CompactGraph NodeOrdering::apply(const CompactGraph& graph, NodeOrder order) {
+        return graph.permuted(compute(graph, order));
+    }
+}
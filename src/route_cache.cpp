@@ -0,0 +1,135 @@
+#include "route_planner/route_cache.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace RoutePlanner {
+    namespace {
+        // List node, hash node and bucket slot per entry, roughly
+        constexpr size_t ENTRY_OVERHEAD = 96;
+
+        size_t mix(size_t hash, uint64_t value) {
+            // boost::hash_combine, widened
+            return hash ^ (std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+        }
+    }
+
+    bool RouteCache::Key::operator==(const Key& other) const {
+        return graphVersion == other.graphVersion && startId == other.startId && endId == other.endId
+            && landmarks == other.landmarks && heuristic == other.heuristic && queue == other.queue
+            && bidirectional == other.bidirectional;
+    }
+
+    size_t RouteCache::KeyHash::operator()(const Key& key) const {
+        size_t hash = std::hash<uint64_t>()(key.graphVersion);
+        hash = mix(hash, static_cast<uint32_t>(key.startId));
+        hash = mix(hash, static_cast<uint32_t>(key.endId));
+        hash = mix(hash, reinterpret_cast<uintptr_t>(key.landmarks));
+        hash = mix(hash, static_cast<uint64_t>(key.heuristic) << 8 | static_cast<uint64_t>(key.queue) << 1
+                             | key.bidirectional);
+        return hash;
+    }
+
+    RouteCache::RouteCache(size_t maxBytes, size_t numShards) {
+        numShards = std::max<size_t>(1, numShards);
+        shards.reserve(numShards);
+        for (size_t i = 0; i < numShards; ++i) shards.push_back(std::make_unique<Shard>());
+        shardBudget = maxBytes / numShards;
+    }
+
+    RouteCache::Key RouteCache::makeKey(const CompactGraph& graph, int startId, int endId,
+                                        const RouteOptions& options) {
+        // Landmarks only matter to the ALT heuristic
+        const void* landmarks = options.heuristic == HeuristicType::Landmark ? options.landmarks : nullptr;
+        return Key{graph.version(), startId, endId, landmarks, options.heuristic, options.queue, options.bidirectional};
+    }
+
+    RouteCache::Shard& RouteCache::shardOf(const Key& key) {
+        // High bits, the bucket index inside the shard uses the low ones
+        uint64_t hash = KeyHash()(key);
+        return *shards[(hash >> 32 ^ hash >> 16) % shards.size()];
+    }
+
+    bool RouteCache::lookup(const CompactGraph& graph, int startId, int endId, const RouteOptions& options,
+                            RouteResult& result) {
+        Key key = makeKey(graph, startId, endId, options);
+        Shard& shard = shardOf(key);
+        std::shared_ptr<const RouteResult> cached;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it == shard.index.end()) {
+                ++shard.misses;
+                return false;
+            }
+            ++shard.hits;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            cached = it->second->result;
+        }
+        result = *cached;
+        result.stats = {};
+        return true;
+    }
+
+    void RouteCache::insert(const CompactGraph& graph, int startId, int endId, const RouteOptions& options,
+                            const RouteResult& result) {
+        Key key = makeKey(graph, startId, endId, options);
+        auto stored = std::make_shared<RouteResult>(result);
+        stored->stats = {};
+        const size_t bytes = sizeof(Entry) + sizeof(RouteResult) + stored->path.capacity() * sizeof(int) + ENTRY_OVERHEAD;
+        if (bytes > shardBudget) return; // Would evict everything and still not fit
+
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            // Raced with another thread computing the same route, keep the newer one
+            shard.bytes -= it->second->bytes;
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+        }
+
+        shard.lru.push_front(Entry{key, std::move(stored), bytes});
+        shard.index.emplace(key, shard.lru.begin());
+        shard.bytes += bytes;
+
+        while (shard.bytes > shardBudget) {
+            const Entry& victim = shard.lru.back();
+            shard.bytes -= victim.bytes;
+            shard.index.erase(victim.key);
+            shard.lru.pop_back();
+            ++shard.evictions;
+        }
+    }
+
+    RouteResult RouteCache::computePath(const CompactGraph& graph, int startId, int endId, const RouteOptions& options) {
+        RouteResult result;
+        if (lookup(graph, startId, endId, options, result)) return result;
+
+        result = Router::computePath(graph, startId, endId, options);
+        // A cancelled search says nothing about the route, don't remember it
+        if (!(options.cancel && options.cancel->load())) insert(graph, startId, endId, options, result);
+        return result;
+    }
+
+    void RouteCache::clear() {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->lru.clear();
+            shard->index.clear();
+            shard->bytes = 0;
+        }
+    }
+
+    RouteCacheStats RouteCache::stats() const {
+        RouteCacheStats total;
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total.hits += shard->hits;
+            total.misses += shard->misses;
+            total.evictions += shard->evictions;
+            total.entries += shard->lru.size();
+            total.bytes += shard->bytes;
+        }
+        return total;
+    }
+}
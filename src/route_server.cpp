@@ -0,0 +1,233 @@
+#include "route_planner/route_server.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace RoutePlanner {
+    namespace {
+        // Answers waiting for the writer; workers stall above this (backpressure from 'out')
+        constexpr size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+        struct Request {
+            std::string tag;
+            int startId = -1;
+            int endId = -1;
+            std::string error; // Set if the line didn't parse
+        };
+
+        // FIFO with a fixed capacity: push() blocks while full, pop() while empty
+        template <typename T>
+        class BoundedQueue {
+        public:
+            explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+            void push(T item) {
+                std::unique_lock<std::mutex> lock(mutex);
+                notFull.wait(lock, [this]() { return items.size() < capacity; });
+                items.push_back(std::move(item));
+                notEmpty.notify_one();
+            }
+
+            // False once closed and drained
+            bool pop(T& item) {
+                std::unique_lock<std::mutex> lock(mutex);
+                notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+                if (items.empty()) return false;
+                item = std::move(items.front());
+                items.pop_front();
+                notFull.notify_one();
+                return true;
+            }
+
+            // No more pushes; wakes every waiting pop()
+            void close() {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+                notEmpty.notify_all();
+            }
+
+        private:
+            const size_t capacity;
+            std::deque<T> items;
+            std::mutex mutex;
+            std::condition_variable notFull;
+            std::condition_variable notEmpty;
+            bool closed = false;
+        };
+
+        // Answers appended by workers, written out in bulk by one thread
+        class OutputBuffer {
+        public:
+            void append(const std::string& text) {
+                std::unique_lock<std::mutex> lock(mutex);
+                drained.wait(lock, [this]() { return pending.size() < MAX_PENDING_OUTPUT; });
+                pending += text;
+                ready.notify_one();
+            }
+
+            void finish() {
+                std::lock_guard<std::mutex> lock(mutex);
+                done = true;
+                ready.notify_one();
+            }
+
+            // Writer thread: swap out everything pending, write it without the lock held
+            void drainTo(std::ostream& out) {
+                std::string chunk;
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ready.wait(lock, [this]() { return done || !pending.empty(); });
+                        if (pending.empty()) return;
+                        chunk.swap(pending);
+                        pending.clear();
+                        drained.notify_all();
+                    }
+                    out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                    out.flush();
+                }
+            }
+
+        private:
+            std::string pending;
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::condition_variable drained;
+            bool done = false;
+        };
+
+        bool parseInt(std::string_view token, int& value) {
+            auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+            return ec == std::errc() && end == token.data() + token.size();
+        }
+
+        // Return false for lines to skip (blank or comment)
+        bool parseRequest(std::string_view line, Request& request) {
+            std::string_view tokens[4];
+            size_t count = 0;
+            size_t pos = 0;
+            while (count < 4) {
+                pos = line.find_first_not_of(" \t\r", pos);
+                if (pos == std::string_view::npos) break;
+                size_t end = line.find_first_of(" \t\r", pos);
+                if (end == std::string_view::npos) end = line.size();
+                tokens[count++] = line.substr(pos, end - pos);
+                pos = end;
+            }
+            if (count == 0 || tokens[0].front() == '#') return false;
+
+            request.tag = std::string(tokens[0]);
+            if (count != 3 || !parseInt(tokens[1], request.startId) || !parseInt(tokens[2], request.endId)) {
+                request.error = "expected: <tag> <startId> <endId>";
+            }
+            return true;
+        }
+
+        void appendNumber(std::string& out, double value) {
+            char buffer[32];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, end);
+        }
+
+        void appendNumber(std::string& out, int value) {
+            char buffer[16];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, end);
+        }
+
+        void answer(const CompactGraph& graph, const RouteOptions& options, const Request& request, std::string& out) {
+            out += request.tag;
+            if (!request.error.empty()) {
+                out += " error " + request.error + "\n";
+                return;
+            }
+            for (int id : {request.startId, request.endId}) {
+                if (graph.indexOf(id) == -1) {
+                    out += " error unknown node ";
+                    appendNumber(out, id);
+                    out += "\n";
+                    return;
+                }
+            }
+
+            RouteResult result;
+            try {
+                result = Router::computePath(graph, request.startId, request.endId, options);
+            } catch (const std::exception& e) {
+                out += std::string(" error ") + e.what() + "\n";
+                return;
+            }
+            if (!result.success) {
+                out += " none\n";
+                return;
+            }
+            out += " ok ";
+            appendNumber(out, result.totalDist);
+            for (int id : result.path) {
+                out += ' ';
+                appendNumber(out, id);
+            }
+            out += '\n';
+        }
+    }
+
+    size_t RouteServer::serve(const CompactGraph& graph, std::istream& in, std::ostream& out,
+                              const ServerOptions& options) {
+        const size_t numWorkers = options.workers ? options.workers
+                                                  : std::max(1u, std::thread::hardware_concurrency());
+        const size_t batchSize = std::max<size_t>(1, options.batchSize);
+        BoundedQueue<std::vector<Request>> requests(options.queueCapacity ? options.queueCapacity : 4 * numWorkers);
+        OutputBuffer output;
+        std::atomic<size_t> answered{0};
+
+        std::thread writer([&]() { output.drainTo(out); });
+
+        // Workers only read 'graph'; each keeps its own thread-local SearchContext
+        std::vector<std::thread> workers;
+        workers.reserve(numWorkers);
+        for (size_t w = 0; w < numWorkers; ++w) {
+            workers.emplace_back([&]() {
+                std::vector<Request> batch;
+                std::string text;
+                while (requests.pop(batch)) {
+                    text.clear();
+                    for (const Request& request : batch) answer(graph, options.route, request, text);
+                    output.append(text);
+                    answered += batch.size();
+                }
+            });
+        }
+
+        // Hand off a batch when it is full, or early when no more input is buffered,
+        // so a single interactive request isn't held back waiting for company
+        std::vector<Request> batch;
+        batch.reserve(batchSize);
+        std::string line;
+        while (std::getline(in, line)) {
+            Request request;
+            if (parseRequest(line, request)) batch.push_back(std::move(request));
+            if (batch.size() >= batchSize || (!batch.empty() && in.rdbuf()->in_avail() <= 0)) {
+                requests.push(std::move(batch)); // Blocks while the queue is full
+                batch = std::vector<Request>();
+                batch.reserve(batchSize);
+            }
+        }
+        if (!batch.empty()) requests.push(std::move(batch));
+
+        requests.close();
+        for (auto& worker : workers) worker.join();
+        output.finish();
+        writer.join();
+        return answered;
+    }
+}
@@ -1,8 +1,16 @@
 #include "route_planner/router.hpp"
+#include "route_planner/basic_router.hpp"
+#include "route_planner/compressed_graph.hpp"
+#include "route_planner/distance_kernels.hpp"
+#include "route_planner/landmarks.hpp"
+#include "route_planner/thread_pool.hpp"
 #include <queue>
+#include <set>
 #include <limits>
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
+#include <type_traits>
 
 namespace RoutePlanner {
 
@@ -22,7 +30,9 @@ namespace RoutePlanner {
     // Helper function to calculate straight-line (Euclidean distance)
     double calculateHeuristic(const Node* a, const Node* b) {
         if (!a || !b) return 0.0;
-        return std::sqrt(std::pow(a->x - b->x, 2) + std::pow(a->y - b->y, 2));
+        double dx = a->x - b->x;
+        double dy = a->y - b->y;
+        return std::sqrt(dx * dx + dy * dy);
     }
 
     RouteResult Router::computePath(const Graph& graph, int startId, int endId) {
@@ -43,10 +53,12 @@ namespace RoutePlanner {
         const Node* endNode = graph.getNode(endId);
         if (!endNode) return { {}, 0.0, false };
 
-        // Init all distances to infinity
-        for (const auto& pair : graph.getAllNodes()) {
-            gScores[pair.first] = std::numeric_limits<double>::infinity();
-        }
+        // Nodes missing from gScores are at infinity
+        // Avoids touching every node in the map before each search
+        auto gScoreOf = [&](int id) {
+            auto it = gScores.find(id);
+            return it != gScores.end() ? it->second : std::numeric_limits<double>::infinity();
+        };
 
         // Start algo
         gScores[startId] = 0.0;
@@ -68,18 +80,19 @@ namespace RoutePlanner {
                 break;
             }
 
-            // If found better path before, skip
-            // if (current.dist > distances[current.id]) continue;
-
             const Node* node = graph.getNode(current.id);
             if (!node) continue; // Safety check
 
+            // If found better path before, this entry is a stale duplicate, skip
+            // Same g + h sum as when the fresh entry was pushed, so the compare is exact
+            if (current.fScore > gScoreOf(current.id) + calculateHeuristic(node, endNode)) continue;
+
             // Check all neighbors
             for (const auto& edge : node->neighbors) {
-                double tentativeGScore = gScores[current.id] + edge.distance;
+                double tentativeGScore = gScoreOf(current.id) + edge.distance;
 
                 // If found shorter path to neighbor
-                if (tentativeGScore < gScores[edge.targetNodeID]) {
+                if (tentativeGScore < gScoreOf(edge.targetNodeID)) {
                     gScores[edge.targetNodeID] = tentativeGScore;
                     parents[edge.targetNodeID] = current.id;
 
@@ -113,4 +126,930 @@ namespace RoutePlanner {
 
         return result;
     }
+
+    namespace {
+        // Straight-line distance to the target, read from SoA coordinates
+        struct EuclideanHeuristic {
+            const double* xs;
+            const double* ys;
+            double targetX, targetY;
+
+            double operator()(int i) const {
+                double dx = xs[i] - targetX;
+                double dy = ys[i] - targetY;
+                return std::sqrt(dx * dx + dy * dy);
+            }
+
+            // Whole neighbour block at once, vectorized where the CPU allows (see distance_kernels.hpp)
+            void batch(const int* nodes, size_t count, double* out) const {
+                DistanceKernels::euclidean(xs, ys, nodes, count, targetX, targetY, out);
+            }
+        };
+
+        // Heuristics with a batch() member, evaluated per neighbour block on high-degree nodes
+        template <typename Heuristic>
+        constexpr bool hasBatch = std::is_same_v<Heuristic, EuclideanHeuristic>;
+
+        // Below this out-degree a block isn't worth the kernel call; road junctions are mostly 2-4
+        constexpr uint32_t BATCH_MIN_DEGREE = 6;
+        constexpr uint32_t BATCH_SIZE = 32; // Heuristic values held on the stack per block
+
+        // Dijkstra: every node looks equally close
+        struct ZeroHeuristic {
+            double operator()(int) const { return 0.0; }
+        };
+
+        // Bound in other units, e.g. weight codes of a CompressedGraph (scale = 1 / resolution)
+        template <typename Heuristic>
+        struct ScaledHeuristic {
+            Heuristic heuristic;
+            double scale;
+
+            double operator()(int i) const { return heuristic(i) * scale; }
+        };
+
+        // ALT: triangle inequality over precomputed landmark distances
+        // Bounds d(i, anchor), or d(anchor, i) for the backward side of a bidirectional search
+        template <bool Backward>
+        struct LandmarkHeuristic {
+            const Landmarks* landmarks;
+            int anchor;
+
+            double operator()(int i) const {
+                return Backward ? landmarks->lowerBound(anchor, i) : landmarks->lowerBound(i, anchor);
+            }
+        };
+
+        SearchContext& threadContext() {
+            // One workspace per thread, reused across calls
+            thread_local SearchContext context;
+            return context;
+        }
+
+        // Second workspace for the backward side of bidirectional searches
+        SearchContext& threadBackwardContext() {
+            thread_local SearchContext context;
+            return context;
+        }
+
+        template <typename Queue>
+        Queue& cleared(Queue& queue, size_t numNodes) {
+            queue.clear(numNodes);
+            return queue;
+        }
+
+        // Run 'search(queue)' on the frontier picked by 'type', stored in 'context'
+        template <typename Search>
+        auto withQueue(QueueType type, SearchContext& context, size_t numNodes, Search search) {
+            switch (type) {
+                case QueueType::FourAryHeap:
+                    return search(cleared(context.fourAryHeap(), numNodes));
+                case QueueType::RadixHeap:
+                    return search(cleared(context.radixHeap(), numNodes));
+                case QueueType::BinaryHeap:
+                default: {
+                    BinaryHeap queue(context.queue());
+                    return search(cleared(queue, numNodes));
+                }
+            }
+        }
+
+        // Same, with one frontier per direction
+        template <typename Search>
+        auto withQueues(QueueType type, SearchContext& forward, SearchContext& backward, size_t numNodes, Search search) {
+            switch (type) {
+                case QueueType::FourAryHeap:
+                    return search(cleared(forward.fourAryHeap(), numNodes), cleared(backward.fourAryHeap(), numNodes));
+                case QueueType::RadixHeap:
+                    return search(cleared(forward.radixHeap(), numNodes), cleared(backward.radixHeap(), numNodes));
+                case QueueType::BinaryHeap:
+                default: {
+                    BinaryHeap forwardQueue(forward.queue());
+                    BinaryHeap backwardQueue(backward.queue());
+                    return search(cleared(forwardQueue, numNodes), cleared(backwardQueue, numNodes));
+                }
+            }
+        }
+
+        // Edge scans per layout, so the searches below serve both graph types
+        // visit(neighbour, weight) per out-edge (in-edge) of 'node'
+        template <typename Visit>
+        void forEachOutEdge(const CompactGraph& graph, int node, Visit&& visit) {
+            // Raw CSR arrays, read sequentially per node
+            const int* targets = graph.targetData();
+            const double* weights = graph.weightData();
+            for (uint32_t e = graph.edgeBegin(node); e < graph.edgeEnd(node); ++e) visit(targets[e], weights[e]);
+        }
+
+        template <typename Visit>
+        void forEachInEdge(const CompactGraph& graph, int node, Visit&& visit) {
+            const int* sources = graph.sourceData();
+            const double* weights = graph.inWeightData();
+            for (uint32_t e = graph.inEdgeBegin(node); e < graph.inEdgeEnd(node); ++e) visit(sources[e], weights[e]);
+        }
+
+        // Decoded on the fly, see compressed_graph.hpp
+        template <typename Visit>
+        void forEachOutEdge(const CompressedGraph& graph, int node, Visit&& visit) {
+            graph.forEachOutEdge(node, visit);
+        }
+
+        template <typename Visit>
+        void forEachInEdge(const CompressedGraph& graph, int node, Visit&& visit) {
+            graph.forEachInEdge(node, visit);
+        }
+
+        // RouteOptions::cancel and onProgress, checked by the searches on every expanded node
+        // Real work happens once per WATCH_INTERVAL nodes, so queries using neither pay one branch
+        class SearchWatch {
+        public:
+            explicit SearchWatch(const RouteOptions& options)
+                : cancel(options.cancel), progress(options.onProgress ? &options.onProgress : nullptr) {}
+
+            // False once the query has been cancelled
+            template <typename GraphType>
+            bool expanded(const GraphType& graph, int node) {
+                if (!cancel && !progress) return true;
+                if (progress) batch.push_back(graph.idOf(node));
+                if (++count % WATCH_INTERVAL != 0) return true;
+                flush();
+                return !(cancel && cancel->load(std::memory_order_relaxed));
+            }
+
+            // Report what is left, at the end of a search
+            void flush() {
+                if (!progress || batch.empty()) return;
+                (*progress)(batch);
+                batch.clear();
+            }
+
+        private:
+            static constexpr uint32_t WATCH_INTERVAL = 256;
+
+            const std::atomic<bool>* cancel;
+            const std::function<void(const std::vector<int>&)>* progress;
+            std::vector<int> batch;
+            uint32_t count = 0;
+        };
+
+        // Neither cancel nor progress, for BasicRouter
+        struct NoWatch {
+            template <typename GraphType>
+            bool expanded(const GraphType&, int) { return true; }
+            void flush() {}
+        };
+
+        // A* over a CompactGraph or CompressedGraph, heuristic, frontier and recorder inlined per instantiation
+        // DistanceOnly skips parent writes; Weight = uint32_t adds CompressedGraph weight codes
+        // without decoding them, so distances (and 'heuristic') are in units of resolution()
+        // They are still held as doubles in 'context' and 'pq', exact for integer sums below 2^53
+        // 'context' must be reset() and 'pq' cleared for this graph
+        template <typename Output = WithPath, typename Weight = double, typename GraphType, typename Heuristic,
+                  typename Queue, typename Recorder, typename Watch>
+        bool aStar(const GraphType& graph, int start, int end, const Heuristic& heuristic, SearchContext& context,
+                   Queue& pq, Recorder& recorder, Watch& watch) {
+            auto push = [&](int id, double key) {
+                pq.push(id, key);
+                recorder.push(pq.size());
+            };
+
+            context.update(start, 0.0, -1);
+            push(start, heuristic(start));
+
+            while (!pq.empty()) {
+                QueueEntry current = pq.pop();
+
+                if (current.id == end) return true;
+
+                // Skip stale duplicates of already expanded nodes
+                if (context.settled(current.id)) {
+                    recorder.stalePop();
+                    continue;
+                }
+                context.settle(current.id);
+                recorder.settle();
+                if (!watch.expanded(graph, current.id)) return false; // Cancelled
+
+                const double g = context.dist(current.id);
+                const int from = current.id;
+                // 'h(next)' gives the heuristic of 'next', computed on demand or read from a batch
+                auto relax = [&](int next, double weight, const auto& h) {
+                    recorder.relax();
+                    const double tentativeGScore = g + weight;
+                    if (tentativeGScore < context.dist(next)) {
+                        if constexpr (std::is_same_v<Output, WithPath>) context.update(next, tentativeGScore, from);
+                        else context.update(next, tentativeGScore);
+
+                        // Infinite bound: target provably unreachable from 'next'
+                        double bound = h(next);
+                        if (bound != std::numeric_limits<double>::infinity()) push(next, tentativeGScore + bound);
+                    }
+                };
+
+                if constexpr (hasBatch<Heuristic> && std::is_same_v<GraphType, CompactGraph>) {
+                    if (graph.degree(from) >= BATCH_MIN_DEGREE) {
+                        const int* targets = graph.targetData();
+                        const double* weights = graph.weightData();
+                        double bounds[BATCH_SIZE];
+                        for (uint32_t e = graph.edgeBegin(from); e < graph.edgeEnd(from); e += BATCH_SIZE) {
+                            const uint32_t count = std::min(BATCH_SIZE, graph.edgeEnd(from) - e);
+                            heuristic.batch(targets + e, count, bounds);
+                            for (uint32_t k = 0; k < count; ++k) {
+                                relax(targets[e + k], weights[e + k], [&](int) { return bounds[k]; });
+                            }
+                        }
+                        continue;
+                    }
+                }
+                if constexpr (std::is_integral_v<Weight>) {
+                    graph.forEachOutCode(from, [&](int next, Weight code) { relax(next, code, heuristic); });
+                } else {
+                    forEachOutEdge(graph, from, [&](int next, double weight) { relax(next, weight, heuristic); });
+                }
+            }
+            return false;
+        }
+
+        // Bidirectional A*: forward from start over out-edges, backward from end over in-edges
+        // Both sides use the average potential p(v) = (toEnd(v) - toStart(v)) / 2 (backward: -p),
+        // which keeps reduced edge costs non-negative on both sides when the
+        // heuristics are consistent. With it, the search can stop as soon as
+        // topForward + topBackward >= best meeting cost. Returns the meeting node, -1 if none
+        // Keys are stored relative to each side's start key, so they begin at 0 and
+        // never decrease, as the radix heap requires
+        // Both contexts must be reset() and both queues cleared for this graph
+        template <typename GraphType, typename ToEnd, typename ToStart, typename Queue, typename Recorder>
+        int bidirectionalAStar(const GraphType& graph, int start, int end, const ToEnd& toEnd, const ToStart& toStart,
+                               SearchContext& forward, SearchContext& backward, Queue& forwardQueue, Queue& backwardQueue,
+                               double& best, Recorder& recorder, SearchWatch& watch) {
+            auto potential = [&](int v) { return 0.5 * (toEnd(v) - toStart(v)); };
+            const double forwardBase = potential(start);
+            const double backwardBase = -potential(end);
+
+            auto push = [&recorder](Queue& pq, int id, double key) {
+                // Infinite/NaN keys come from ALT proving a node useless
+                if (!std::isfinite(key)) return;
+                pq.push(id, key);
+                recorder.push(pq.size());
+            };
+
+            forward.update(start, 0.0, -1);
+            push(forwardQueue, start, 0.0);
+            backward.update(end, 0.0, -1);
+            push(backwardQueue, end, 0.0);
+
+            best = std::numeric_limits<double>::infinity();
+            int meet = -1;
+
+            // Stale tops would hold back the stopping test, drop them first
+            auto dropSettled = [&recorder](SearchContext& ctx, Queue& pq) {
+                while (!pq.empty() && ctx.settled(pq.top().id)) {
+                    pq.pop();
+                    recorder.stalePop();
+                }
+            };
+
+            // Once one side runs dry, every path it could still find has been seen
+            while (true) {
+                dropSettled(forward, forwardQueue);
+                dropSettled(backward, backwardQueue);
+                if (forwardQueue.empty() || backwardQueue.empty()) break;
+                const double forwardKey = forwardQueue.top().key + forwardBase;
+                const double backwardKey = backwardQueue.top().key + backwardBase;
+                if (forwardKey + backwardKey >= best) break;
+
+                // Expand the side with the smaller key
+                const bool isForward = forwardKey <= backwardKey;
+                SearchContext& self = isForward ? forward : backward;
+                SearchContext& other = isForward ? backward : forward;
+                Queue& pq = isForward ? forwardQueue : backwardQueue;
+
+                QueueEntry current = pq.pop();
+                self.settle(current.id);
+                recorder.settle();
+                if (!watch.expanded(graph, current.id)) return -1; // Cancelled
+
+                const double sign = isForward ? 1.0 : -1.0;
+                const double base = isForward ? forwardBase : backwardBase;
+
+                const double g = self.dist(current.id);
+                const int from = current.id;
+                auto relax = [&](int next, double weight) {
+                    recorder.relax();
+                    const double tentativeGScore = g + weight;
+                    if (tentativeGScore < self.dist(next)) {
+                        self.update(next, tentativeGScore, from);
+                        push(pq, next, tentativeGScore + sign * potential(next) - base);
+
+                        // Frontiers touch: candidate path through 'next'
+                        if (other.reached(next) && tentativeGScore + other.dist(next) < best) {
+                            best = tentativeGScore + other.dist(next);
+                            meet = next;
+                        }
+                    }
+                };
+                if (isForward) forEachOutEdge(graph, from, relax);
+                else forEachInEdge(graph, from, relax);
+            }
+            return meet;
+        }
+
+        template <typename GraphType>
+        RouteResult buildResult(const GraphType& graph, const SearchContext& context, int end, bool found) {
+            RouteResult result;
+            if (found) {
+                result.success = true;
+                result.totalDist = context.dist(end);
+
+                // Backtrack in dense space, translate to external IDs
+                for (int curr = end; curr != -1; curr = context.parent(curr)) {
+                    result.path.push_back(graph.idOf(curr));
+                }
+                std::reverse(result.path.begin(), result.path.end());
+            } else {
+                result.success = false;
+                result.totalDist = 0.0;
+            }
+            return result;
+        }
+    }
+
+    RouteResult Router::computePath(const CompactGraph& graph, int startId, int endId) {
+        return computePath(graph, startId, endId, RouteOptions{}, threadContext());
+    }
+
+    RouteResult Router::computePath(const CompactGraph& graph, int startId, int endId, SearchContext& context) {
+        return computePath(graph, startId, endId, RouteOptions{}, context);
+    }
+
+    RouteResult Router::computePath(const CompactGraph& graph, int startId, int endId, const RouteOptions& options) {
+        return computePath(graph, startId, endId, options, threadContext());
+    }
+
+    namespace {
+        // StatsAggregator label per engine and heuristic
+        const char* engineLabel(HeuristicType heuristic, bool bidirectional) {
+            switch (heuristic) {
+                case HeuristicType::Zero: return bidirectional ? "bidirectional_dijkstra" : "dijkstra";
+                case HeuristicType::Landmark: return bidirectional ? "bidirectional_alt" : "alt";
+                case HeuristicType::Euclidean:
+                default: return bidirectional ? "bidirectional_astar" : "astar";
+            }
+        }
+
+        template <typename GraphType>
+        void checkLandmarks(const GraphType& graph, const RouteOptions& options) {
+            if (options.heuristic == HeuristicType::Landmark
+                && (!options.landmarks || options.landmarks->numNodes() != graph.numNodes()
+                    || options.landmarks->layout() != graph.layout()
+                    || options.landmarks->version() != graph.version())) {
+                throw std::invalid_argument("Landmark heuristic needs landmarks built for this graph.");
+            }
+        }
+
+        template <typename GraphType, typename Recorder>
+        RouteResult unidirectional(const GraphType& graph, int startId, int endId, const RouteOptions& options,
+                                   SearchContext& context, Recorder& recorder) {
+            recorder.beginPhase();
+            const size_t bytesBefore = context.bytesReserved();
+            const int start = graph.indexOf(startId);
+            const int end = graph.indexOf(endId);
+            if (start == -1 || end == -1) return endSetup(recorder, RouteResult{ {}, 0.0, false });
+            checkLandmarks(graph, options);
+
+            // O(1) unless the graph is larger than any seen before
+            context.reset(graph.numNodes());
+            recorder.endPhase(&SearchStats::setupMicros);
+
+            recorder.beginPhase();
+            SearchWatch watch(options);
+            bool found = withQueue(options.queue, context, graph.numNodes(), [&](auto& pq) {
+                switch (options.heuristic) {
+                    case HeuristicType::Zero:
+                        return aStar(graph, start, end, ZeroHeuristic{}, context, pq, recorder, watch);
+                    case HeuristicType::Landmark:
+                        return aStar(graph, start, end, LandmarkHeuristic<false>{options.landmarks, end}, context, pq,
+                                     recorder, watch);
+                    case HeuristicType::Euclidean:
+                    default:
+                        return aStar(graph, start, end,
+                                     EuclideanHeuristic{graph.xData(), graph.yData(), graph.x(end), graph.y(end)},
+                                     context, pq, recorder, watch);
+                }
+            });
+            watch.flush();
+            recorder.endPhase(&SearchStats::searchMicros);
+
+            recorder.beginPhase();
+            RouteResult result = buildResult(graph, context, end, found);
+            recorder.endPhase(&SearchStats::pathMicros);
+            recorder.allocated(context.bytesReserved() - bytesBefore + result.path.capacity() * sizeof(int));
+            return result;
+        }
+
+        template <typename GraphType, typename Recorder>
+        RouteResult bidirectional(const GraphType& graph, int startId, int endId, const RouteOptions& options,
+                                  SearchContext& forward, SearchContext& backward, Recorder& recorder) {
+            recorder.beginPhase();
+            const size_t bytesBefore = forward.bytesReserved() + backward.bytesReserved();
+            const int start = graph.indexOf(startId);
+            const int end = graph.indexOf(endId);
+            if (start == -1 || end == -1) return endSetup(recorder, RouteResult{ {}, 0.0, false });
+            if (start == end) return endSetup(recorder, RouteResult{ {startId}, 0.0, true });
+            checkLandmarks(graph, options);
+
+            forward.reset(graph.numNodes());
+            backward.reset(graph.numNodes());
+            recorder.endPhase(&SearchStats::setupMicros);
+
+            recorder.beginPhase();
+            double best = 0.0;
+            SearchWatch watch(options);
+            int meet = withQueues(options.queue, forward, backward, graph.numNodes(),
+                                  [&](auto& forwardQueue, auto& backwardQueue) {
+                switch (options.heuristic) {
+                    case HeuristicType::Zero:
+                        return bidirectionalAStar(graph, start, end, ZeroHeuristic{}, ZeroHeuristic{},
+                                                  forward, backward, forwardQueue, backwardQueue, best, recorder,
+                                                  watch);
+                    case HeuristicType::Landmark:
+                        return bidirectionalAStar(graph, start, end,
+                                                  LandmarkHeuristic<false>{options.landmarks, end},
+                                                  LandmarkHeuristic<true>{options.landmarks, start},
+                                                  forward, backward, forwardQueue, backwardQueue, best, recorder,
+                                                  watch);
+                    case HeuristicType::Euclidean:
+                    default:
+                        return bidirectionalAStar(graph, start, end,
+                                                  EuclideanHeuristic{graph.xData(), graph.yData(), graph.x(end), graph.y(end)},
+                                                  EuclideanHeuristic{graph.xData(), graph.yData(), graph.x(start), graph.y(start)},
+                                                  forward, backward, forwardQueue, backwardQueue, best, recorder,
+                                                  watch);
+                }
+            });
+            watch.flush();
+            recorder.endPhase(&SearchStats::searchMicros);
+            recorder.allocated(forward.bytesReserved() + backward.bytesReserved() - bytesBefore);
+
+            RouteResult result;
+            if (meet == -1) {
+                result.success = false;
+                result.totalDist = 0.0;
+                return result;
+            }
+
+            // start -> meet from forward parents, then meet -> end from backward parents
+            recorder.beginPhase();
+            for (int curr = meet; curr != -1; curr = forward.parent(curr)) result.path.push_back(graph.idOf(curr));
+            std::reverse(result.path.begin(), result.path.end());
+            for (int curr = backward.parent(meet); curr != -1; curr = backward.parent(curr)) result.path.push_back(graph.idOf(curr));
+
+            result.success = true;
+            result.totalDist = best;
+            recorder.endPhase(&SearchStats::pathMicros);
+            recorder.allocated(result.path.capacity() * sizeof(int));
+            return result;
+        }
+    }
+
+    RouteResult Router::computePath(const CompactGraph& graph, int startId, int endId,
+                                    const RouteOptions& options, SearchContext& context) {
+        if (options.bidirectional) {
+            return computePath(graph, startId, endId, options, context, threadBackwardContext());
+        }
+        return runWithStats(options.collectStats, engineLabel(options.heuristic, false), [&](auto& recorder) {
+            return unidirectional(graph, startId, endId, options, context, recorder);
+        });
+    }
+
+    RouteResult Router::computePath(const CompactGraph& graph, int startId, int endId, const RouteOptions& options,
+                                    SearchContext& forward, SearchContext& backward) {
+        return runWithStats(options.collectStats, engineLabel(options.heuristic, true), [&](auto& recorder) {
+            return bidirectional(graph, startId, endId, options, forward, backward, recorder);
+        });
+    }
+
+    RouteResult Router::computePath(const CompressedGraph& graph, int startId, int endId, const RouteOptions& options) {
+        return computePath(graph, startId, endId, options, threadContext());
+    }
+
+    RouteResult Router::computePath(const CompressedGraph& graph, int startId, int endId, const RouteOptions& options,
+                                    SearchContext& context) {
+        if (options.bidirectional) {
+            return runWithStats(options.collectStats, engineLabel(options.heuristic, true), [&](auto& recorder) {
+                return bidirectional(graph, startId, endId, options, context, threadBackwardContext(), recorder);
+            });
+        }
+        return runWithStats(options.collectStats, engineLabel(options.heuristic, false), [&](auto& recorder) {
+            return unidirectional(graph, startId, endId, options, context, recorder);
+        });
+    }
+
+    template <typename GraphType, typename Heuristic, typename Weight, typename Output>
+    typename BasicRouter<GraphType, Heuristic, Weight, Output>::Result
+    BasicRouter<GraphType, Heuristic, Weight, Output>::computePath(const GraphType& graph, int startId, int endId) {
+        return computePath(graph, startId, endId, threadContext());
+    }
+
+    template <typename GraphType, typename Heuristic, typename Weight, typename Output>
+    typename BasicRouter<GraphType, Heuristic, Weight, Output>::Result
+    BasicRouter<GraphType, Heuristic, Weight, Output>::computePath(const GraphType& graph, int startId, int endId,
+                                                                   SearchContext& context) {
+        constexpr bool distanceOnly = std::is_same_v<Output, DistanceOnly>;
+        const int start = graph.indexOf(startId);
+        const int end = graph.indexOf(endId);
+        if (start == -1 || end == -1) {
+            if constexpr (distanceOnly) return std::numeric_limits<double>::infinity();
+            else return { {}, 0.0, false };
+        }
+
+        context.reset(graph.numNodes());
+        BinaryHeap pq(context.queue());
+        cleared(pq, graph.numNodes());
+        NoStats recorder;
+        NoWatch watch;
+
+        // Distances come back in weight codes, scaled once here
+        double unit = 1.0;
+        if constexpr (std::is_integral_v<Weight>) unit = graph.resolution();
+
+        bool found;
+        if constexpr (std::is_same_v<Heuristic, ZeroBound>) {
+            found = aStar<Output, Weight>(graph, start, end, ZeroHeuristic{}, context, pq, recorder, watch);
+        } else {
+            EuclideanHeuristic euclidean{graph.xData(), graph.yData(), graph.x(end), graph.y(end)};
+            if constexpr (std::is_integral_v<Weight>) {
+                found = aStar<Output, Weight>(graph, start, end, ScaledHeuristic<EuclideanHeuristic>{euclidean, 1.0 / unit},
+                                              context, pq, recorder, watch);
+            } else {
+                found = aStar<Output, Weight>(graph, start, end, euclidean, context, pq, recorder, watch);
+            }
+        }
+
+        if constexpr (distanceOnly) {
+            return found ? context.dist(end) * unit : std::numeric_limits<double>::infinity();
+        } else {
+            RouteResult result = buildResult(graph, context, end, found);
+            result.totalDist *= unit;
+            return result;
+        }
+    }
+
+    template class BasicRouter<CompactGraph, ZeroBound, double, WithPath>;
+    template class BasicRouter<CompactGraph, ZeroBound, double, DistanceOnly>;
+    template class BasicRouter<CompactGraph, EuclideanBound, double, WithPath>;
+    template class BasicRouter<CompactGraph, EuclideanBound, double, DistanceOnly>;
+    template class BasicRouter<CompressedGraph, ZeroBound, uint32_t, WithPath>;
+    template class BasicRouter<CompressedGraph, ZeroBound, uint32_t, DistanceOnly>;
+    template class BasicRouter<CompressedGraph, EuclideanBound, uint32_t, WithPath>;
+    template class BasicRouter<CompressedGraph, EuclideanBound, uint32_t, DistanceOnly>;
+
+    DistanceMatrix Router::distanceMatrix(const CompactGraph& graph, const std::vector<int>& sources,
+                                          const std::vector<int>& targets, bool withPaths, ThreadPool* pool) {
+        DistanceMatrix matrix;
+        matrix.rows = sources.size();
+        matrix.cols = targets.size();
+        matrix.distances.assign(matrix.rows * matrix.cols, std::numeric_limits<double>::infinity());
+        if (withPaths) matrix.paths.resize(matrix.rows * matrix.cols);
+        if (matrix.rows == 0 || matrix.cols == 0) return matrix;
+
+        // Dense target indices, shared read-only by all rows
+        // isTarget lets a row count settled targets without a lookup per column
+        std::vector<int> targetIndex(targets.size());
+        std::vector<char> isTarget(graph.numNodes(), 0);
+        size_t distinctTargets = 0;
+        for (size_t c = 0; c < targets.size(); ++c) {
+            targetIndex[c] = graph.indexOf(targets[c]);
+            if (targetIndex[c] != -1 && !isTarget[targetIndex[c]]) {
+                isTarget[targetIndex[c]] = 1;
+                ++distinctTargets;
+            }
+        }
+        if (distinctTargets == 0) return matrix;
+
+        const uint32_t* offsets = graph.offsetData();
+        const int* heads = graph.targetData();
+        const double* weights = graph.weightData();
+
+        auto computeRow = [&](size_t row) {
+            const int source = graph.indexOf(sources[row]);
+            if (source == -1) return;
+
+            // Each worker thread keeps its own workspace
+            SearchContext& context = threadContext();
+            context.reset(graph.numNodes());
+            auto& pq = context.queue();
+            context.update(source, 0.0, -1);
+            pq.push_back({0.0, source});
+
+            size_t remaining = distinctTargets;
+            while (!pq.empty() && remaining > 0) {
+                std::pop_heap(pq.begin(), pq.end(), std::greater<QueueEntry>());
+                QueueEntry current = pq.back();
+                pq.pop_back();
+
+                if (context.settled(current.id)) continue;
+                context.settle(current.id);
+                if (isTarget[current.id]) --remaining;
+
+                for (uint32_t e = offsets[current.id]; e < offsets[current.id + 1]; ++e) {
+                    const double d = current.key + weights[e];
+                    if (d < context.dist(heads[e])) {
+                        context.update(heads[e], d, current.id);
+                        pq.push_back({d, heads[e]});
+                        std::push_heap(pq.begin(), pq.end(), std::greater<QueueEntry>());
+                    }
+                }
+            }
+
+            // Fill the row; every reachable target is settled at this point
+            for (size_t c = 0; c < matrix.cols; ++c) {
+                const int target = targetIndex[c];
+                if (target == -1 || !context.settled(target)) continue;
+
+                matrix.distances[row * matrix.cols + c] = context.dist(target);
+                if (withPaths) {
+                    auto& path = matrix.paths[row * matrix.cols + c];
+                    for (int curr = target; curr != -1; curr = context.parent(curr)) path.push_back(graph.idOf(curr));
+                    std::reverse(path.begin(), path.end());
+                }
+            }
+        };
+
+        // Rows write disjoint slices of the matrix, no locking needed
+        (pool ? *pool : ThreadPool::shared()).parallelFor(matrix.rows, computeRow);
+        return matrix;
+    }
+
+    DistanceMatrix Router::distanceMatrix(const Graph& graph, const std::vector<int>& sources,
+                                          const std::vector<int>& targets, bool withPaths, ThreadPool* pool) {
+        return distanceMatrix(graph.freeze(), sources, targets, withPaths, pool);
+    }
+
+    namespace {
+        // Andrew's monotone chain, counter-clockwise, collinear points dropped
+        void convexHull(std::vector<std::pair<double, double>>& points, std::vector<double>& hullX,
+                        std::vector<double>& hullY) {
+            std::sort(points.begin(), points.end());
+            points.erase(std::unique(points.begin(), points.end()), points.end());
+            if (points.size() < 3) {
+                for (const auto& [x, y] : points) {
+                    hullX.push_back(x);
+                    hullY.push_back(y);
+                }
+                return;
+            }
+
+            auto cross = [](const std::pair<double, double>& o, const std::pair<double, double>& a,
+                            const std::pair<double, double>& b) {
+                return (a.first - o.first) * (b.second - o.second) - (a.second - o.second) * (b.first - o.first);
+            };
+            std::vector<std::pair<double, double>> hull(2 * points.size());
+            size_t k = 0;
+            for (size_t i = 0; i < points.size(); ++i) { // Lower half
+                while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) --k;
+                hull[k++] = points[i];
+            }
+            for (size_t i = points.size() - 1, lower = k + 1; i > 0; --i) { // Upper half
+                while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) --k;
+                hull[k++] = points[i - 1];
+            }
+            hull.resize(k - 1); // Last point repeats the first
+
+            for (const auto& [x, y] : hull) {
+                hullX.push_back(x);
+                hullY.push_back(y);
+            }
+        }
+    }
+
+    Isochrone Router::reachableWithin(const CompactGraph& graph, int sourceId, double budget, bool withBoundary) {
+        return reachableWithin(graph, sourceId, budget, threadContext(), withBoundary);
+    }
+
+    Isochrone Router::reachableWithin(const CompactGraph& graph, int sourceId, double budget, SearchContext& context,
+                                      bool withBoundary) {
+        Isochrone isochrone;
+        const int source = graph.indexOf(sourceId);
+        if (source == -1 || !(budget >= 0.0)) return isochrone;
+
+        const uint32_t* offsets = graph.offsetData();
+        const int* heads = graph.targetData();
+        const double* weights = graph.weightData();
+
+        context.reset(graph.numNodes());
+        BinaryHeap pq(context.queue());
+        context.update(source, 0.0, -1);
+        pq.push(source, 0.0);
+
+        std::vector<std::pair<double, double>> points; // Hull input
+        while (!pq.empty()) {
+            QueueEntry current = pq.pop();
+            if (current.key > budget) break; // Everything left costs more
+            if (context.settled(current.id)) continue;
+            context.settle(current.id);
+            isochrone.nodes.push_back(graph.idOf(current.id));
+            isochrone.costs.push_back(current.key);
+            if (withBoundary) points.emplace_back(graph.x(current.id), graph.y(current.id));
+
+            for (uint32_t e = offsets[current.id]; e < offsets[current.id + 1]; ++e) {
+                const int next = heads[e];
+                const double d = current.key + weights[e];
+                if (d <= budget) {
+                    if (d < context.dist(next)) {
+                        context.update(next, d, current.id);
+                        pq.push(next, d);
+                    }
+                } else if (withBoundary && weights[e] > 0.0) {
+                    // Budget runs out part-way along this edge, assume cost spreads evenly over it
+                    const double t = (budget - current.key) / weights[e];
+                    points.emplace_back(graph.x(current.id) + t * (graph.x(next) - graph.x(current.id)),
+                                        graph.y(current.id) + t * (graph.y(next) - graph.y(current.id)));
+                }
+            }
+        }
+
+        if (withBoundary) convexHull(points, isochrone.boundaryX, isochrone.boundaryY);
+        return isochrone;
+    }
+
+    Isochrone Router::reachableWithin(const Graph& graph, int sourceId, double budget, bool withBoundary) {
+        return reachableWithin(graph.freeze(), sourceId, budget, withBoundary);
+    }
+    namespace {
+        // The reverse tree stops growing at this multiple of the shortest distance
+        // Growing it further (1.25, 1.5, 2) cost more than it saved the spur searches
+        // on grid and geometric benchmarks; results are exact either way
+        constexpr double TREE_STRETCH = 1.0;
+
+        // One loopless path in Yen's algorithm, dense indices
+        struct YenPath {
+            std::vector<int> nodes;
+            std::vector<double> costs; // Cost from the start to nodes[i]
+            size_t deviation = 0; // Where it branched off the path it was spurred from
+        };
+    }
+
+    std::vector<RouteResult> Router::kShortestPaths(const CompactGraph& graph, int startId, int endId, size_t k) {
+        return kShortestPaths(graph, startId, endId, k, threadContext(), threadBackwardContext());
+    }
+
+    std::vector<RouteResult> Router::kShortestPaths(const CompactGraph& graph, int startId, int endId, size_t k,
+                                                    SearchContext& forward, SearchContext& backward) {
+        std::vector<RouteResult> results;
+        const int start = graph.indexOf(startId);
+        const int end = graph.indexOf(endId);
+        if (start == -1 || end == -1 || k == 0) return results;
+        const double infinity = std::numeric_limits<double>::infinity();
+
+        // Reverse shortest-path tree into 'end', grown once and shared by every spur search
+        // Blocking nodes and edges only lengthens paths, so its distances stay lower
+        // bounds for A*, and a spur whose tree path is not blocked needs no search at all
+        // Nodes past the radius get the radius itself as their bound
+        backward.reset(graph.numNodes());
+        BinaryHeap treeQueue(backward.queue());
+        backward.update(end, 0.0, -1);
+        treeQueue.push(end, 0.0);
+        double limit = infinity;
+        double radius = infinity; // Everything closer than this is settled
+        while (!treeQueue.empty()) {
+            QueueEntry current = treeQueue.pop();
+            if (backward.settled(current.id)) continue;
+            if (current.key > limit) {
+                radius = current.key;
+                break;
+            }
+            backward.settle(current.id);
+            if (current.id == start) limit = TREE_STRETCH * current.key;
+
+            forEachInEdge(graph, current.id, [&](int previous, double weight) {
+                const double d = current.key + weight;
+                if (d < backward.dist(previous)) {
+                    backward.update(previous, d, current.id);
+                    treeQueue.push(previous, d);
+                }
+            });
+        }
+        if (!backward.settled(start)) return results; // No path at all
+
+        auto bound = [&](int v) { return backward.settled(v) ? backward.dist(v) : radius; };
+
+        // Append the tree path from 'from' (excluded) to 'end', 'fromCost' being the cost to reach 'from'
+        auto appendTreePath = [&](int from, double fromCost, YenPath& path) {
+            for (int v = backward.parent(from); v != -1; v = backward.parent(v)) {
+                path.nodes.push_back(v);
+                path.costs.push_back(fromCost + backward.dist(from) - backward.dist(v));
+            }
+        };
+
+        std::vector<YenPath> accepted(1);
+        accepted[0].nodes.push_back(start);
+        accepted[0].costs.push_back(0.0);
+        appendTreePath(start, 0.0, accepted[0]);
+
+        std::vector<YenPath> candidates;
+        std::set<std::vector<int>> seen = {accepted[0].nodes};
+        std::vector<int> blockedNext; // First hops out of the spur node taken by accepted paths
+        while (accepted.size() < k) {
+            const size_t last = accepted.size() - 1;
+            // Lawler: spurring before the deviation point only finds paths seen already
+            for (size_t j = accepted[last].deviation; j + 1 < accepted[last].nodes.size(); ++j) {
+                const YenPath& previous = accepted[last];
+                const int spur = previous.nodes[j];
+
+                blockedNext.clear();
+                for (const auto& path : accepted) {
+                    if (path.nodes.size() > j + 1
+                        && std::equal(previous.nodes.begin(), previous.nodes.begin() + j + 1, path.nodes.begin())) {
+                        blockedNext.push_back(path.nodes[j + 1]);
+                    }
+                }
+                auto isBlockedNext = [&](int v) {
+                    return std::find(blockedNext.begin(), blockedNext.end(), v) != blockedNext.end();
+                };
+
+                // Root nodes (all but the spur) are taken out by marking them settled at -inf,
+                // so the search never relaxes or expands them
+                forward.reset(graph.numNodes());
+                for (size_t i = 0; i < j; ++i) {
+                    forward.update(previous.nodes[i], -infinity, -1);
+                    forward.settle(previous.nodes[i]);
+                }
+
+                YenPath candidate;
+                candidate.nodes.assign(previous.nodes.begin(), previous.nodes.begin() + j + 1);
+                candidate.costs.assign(previous.costs.begin(), previous.costs.begin() + j + 1);
+                candidate.deviation = j;
+                const double rootCost = previous.costs[j];
+
+                // Unblocked tree path: already the cheapest spur
+                bool treeUsable = backward.settled(spur) && !isBlockedNext(backward.parent(spur));
+                for (int v = backward.parent(spur); treeUsable && v != -1; v = backward.parent(v)) {
+                    treeUsable = !forward.settled(v);
+                }
+
+                if (treeUsable) {
+                    appendTreePath(spur, rootCost, candidate);
+                } else {
+                    BinaryHeap pq(forward.queue());
+                    pq.clear(graph.numNodes());
+                    forward.update(spur, 0.0, -1);
+                    pq.push(spur, bound(spur));
+                    bool found = false;
+                    while (!pq.empty()) {
+                        QueueEntry current = pq.pop();
+                        if (current.id == end) {
+                            found = true;
+                            break;
+                        }
+                        if (forward.settled(current.id)) continue;
+                        forward.settle(current.id);
+
+                        const double g = forward.dist(current.id);
+                        const bool atSpur = current.id == spur;
+                        forEachOutEdge(graph, current.id, [&](int next, double weight) {
+                            if (atSpur && isBlockedNext(next)) return;
+                            const double tentative = g + weight;
+                            if (tentative < forward.dist(next)) {
+                                const double h = bound(next);
+                                if (h == infinity) return; // Can't reach 'end'
+                                forward.update(next, tentative, current.id);
+                                pq.push(next, tentative + h);
+                            }
+                        });
+                    }
+                    if (!found) continue;
+
+                    const size_t rootSize = candidate.nodes.size();
+                    for (int v = end; v != spur; v = forward.parent(v)) {
+                        candidate.nodes.push_back(v);
+                        candidate.costs.push_back(rootCost + forward.dist(v));
+                    }
+                    std::reverse(candidate.nodes.begin() + rootSize, candidate.nodes.end());
+                    std::reverse(candidate.costs.begin() + rootSize, candidate.costs.end());
+                }
+
+                if (seen.insert(candidate.nodes).second) candidates.push_back(std::move(candidate));
+            }
+
+            if (candidates.empty()) break;
+            // Cheapest next, ties by node sequence so the order is deterministic
+            auto best = std::min_element(candidates.begin(), candidates.end(), [](const YenPath& a, const YenPath& b) {
+                return a.costs.back() != b.costs.back() ? a.costs.back() < b.costs.back() : a.nodes < b.nodes;
+            });
+            accepted.push_back(std::move(*best));
+            candidates.erase(best);
+        }
+
+        results.reserve(accepted.size());
+        for (const auto& path : accepted) {
+            RouteResult result;
+            result.success = true;
+            result.totalDist = path.costs.back();
+            result.path.reserve(path.nodes.size());
+            for (int v : path.nodes) result.path.push_back(graph.idOf(v));
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
 }
\ No newline at end of file
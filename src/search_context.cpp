@@ -0,0 +1,21 @@
+#include "route_planner/search_context.hpp"
+
+namespace RoutePlanner {
+    void SearchContext::reset(size_t numNodes) {
+        heap.clear();
+        settledCount = 0;
+
+        // New slots start at stamp 0, which is always "untouched"
+        if (slots.size() < numNodes) {
+            slots.resize(numNodes, Slot{0.0, -1, 0});
+        }
+
+        generation += 2;
+
+        // On wrap-around old stamps could look current, so clear them once
+        if (generation >= std::numeric_limits<uint32_t>::max() - 1) {
+            for (auto& slot : slots) slot.stamp = 0;
+            generation = 2;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "route_planner/search_stats.hpp"
+#include <sstream>
+
+namespace RoutePlanner {
+    StatsAggregator& StatsAggregator::global() {
+        static StatsAggregator aggregator;
+        return aggregator;
+    }
+
+    void StatsAggregator::record(const std::string& engine, const SearchStats& stats) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Totals& totals = engines[engine];
+        ++totals.queries;
+        totals.sum.settled += stats.settled;
+        totals.sum.stalePops += stats.stalePops;
+        totals.sum.pushes += stats.pushes;
+        totals.sum.relaxations += stats.relaxations;
+        totals.sum.peakQueueSize = std::max(totals.sum.peakQueueSize, stats.peakQueueSize);
+        totals.sum.bytesAllocated += stats.bytesAllocated;
+        totals.sum.setupMicros += stats.setupMicros;
+        totals.sum.searchMicros += stats.searchMicros;
+        totals.sum.pathMicros += stats.pathMicros;
+    }
+
+    std::string StatsAggregator::prometheus() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ostringstream out;
+
+        // One metric family at a time, one line per engine
+        auto family = [&](const char* name, const char* type, const char* help, auto value) {
+            out << "# HELP routeplanner_" << name << " " << help << "\n";
+            out << "# TYPE routeplanner_" << name << " " << type << "\n";
+            for (const auto& [engine, totals] : engines) {
+                out << "routeplanner_" << name << "{engine=\"" << engine << "\"} " << value(totals) << "\n";
+            }
+        };
+
+        family("queries_total", "counter", "Queries run with stats enabled.",
+               [](const Totals& t) { return t.queries; });
+        family("settled_total", "counter", "Nodes settled.",
+               [](const Totals& t) { return t.sum.settled; });
+        family("stale_pops_total", "counter", "Heap pops of already settled nodes.",
+               [](const Totals& t) { return t.sum.stalePops; });
+        family("pushes_total", "counter", "Heap pushes.",
+               [](const Totals& t) { return t.sum.pushes; });
+        family("relaxations_total", "counter", "Edges scanned.",
+               [](const Totals& t) { return t.sum.relaxations; });
+        family("bytes_allocated_total", "counter", "Workspace and result bytes allocated by queries.",
+               [](const Totals& t) { return t.sum.bytesAllocated; });
+        family("peak_queue_size", "gauge", "Largest heap seen by a single query.",
+               [](const Totals& t) { return t.sum.peakQueueSize; });
+
+        out << "# HELP routeplanner_phase_seconds_total Wall time per query phase.\n";
+        out << "# TYPE routeplanner_phase_seconds_total counter\n";
+        for (const auto& [engine, totals] : engines) {
+            const std::pair<const char*, double> phases[] = {
+                {"setup", totals.sum.setupMicros}, {"search", totals.sum.searchMicros}, {"path", totals.sum.pathMicros}};
+            for (const auto& [phase, micros] : phases) {
+                out << "routeplanner_phase_seconds_total{engine=\"" << engine << "\",phase=\"" << phase << "\"} "
+                    << micros / 1e6 << "\n";
+            }
+        }
+        return out.str();
+    }
+
+    SearchStats StatsAggregator::totals(const std::string& engine) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = engines.find(engine);
+        return it != engines.end() ? it->second.sum : SearchStats{};
+    }
+
+    uint64_t StatsAggregator::queries(const std::string& engine) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = engines.find(engine);
+        return it != engines.end() ? it->second.queries : 0;
+    }
+
+    void StatsAggregator::reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        engines.clear();
+    }
+}
@@ -0,0 +1,165 @@
+#include "route_planner/spatial_index.hpp"
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+namespace RoutePlanner {
+    namespace {
+        // Squared distance, saves a sqrt per visited point
+        double squaredDistance(double ax, double ay, double bx, double by) {
+            double dx = ax - bx;
+            double dy = ay - by;
+            return dx * dx + dy * dy;
+        }
+
+        // (distance^2, id) ordered so the worst candidate sits on top of a max-heap
+        using Candidate = std::pair<double, int>;
+
+        // Subtree still to visit: points [lo, hi) split at 'depth'
+        struct Range {
+            size_t lo, hi;
+            int depth;
+        };
+    }
+
+    SpatialIndex::SpatialIndex(const Graph& graph) {
+        points.reserve(graph.getAllNodes().size());
+        for (const auto& [id, node] : graph.getAllNodes()) {
+            points.push_back({node.x, node.y, id});
+        }
+        build(0, points.size(), 0);
+    }
+
+    SpatialIndex::SpatialIndex(const CompactGraph& graph) {
+        points.reserve(graph.numNodes());
+        for (size_t i = 0; i < graph.numNodes(); ++i) {
+            points.push_back({graph.x(i), graph.y(i), graph.idOf(i)});
+        }
+        build(0, points.size(), 0);
+    }
+
+    void SpatialIndex::build(size_t lo, size_t hi, int depth) {
+        if (hi - lo <= 1) return;
+        size_t mid = lo + (hi - lo) / 2;
+
+        // Partition around the median; only the split point has to be in place
+        bool byX = depth % 2 == 0;
+        std::nth_element(points.begin() + lo, points.begin() + mid, points.begin() + hi,
+                         [byX](const Point& a, const Point& b) { return byX ? a.x < b.x : a.y < b.y; });
+
+        build(lo, mid, depth + 1);
+        build(mid + 1, hi, depth + 1);
+    }
+
+    int SpatialIndex::nearest(double x, double y, double maxDistance) const {
+        Candidate best = {maxDistance * maxDistance, -1};
+
+        // Explicit stack instead of recursion
+        std::vector<Range> stack = {{0, points.size(), 0}};
+        while (!stack.empty()) {
+            Range r = stack.back();
+            stack.pop_back();
+            if (r.lo >= r.hi) continue;
+
+            size_t mid = r.lo + (r.hi - r.lo) / 2;
+            const Point& p = points[mid];
+            Candidate candidate = {squaredDistance(x, y, p.x, p.y), p.id};
+            if (candidate.first <= best.first && (best.second == -1 || candidate < best)) best = candidate;
+
+            double diff = (r.depth % 2 == 0) ? x - p.x : y - p.y;
+            Range nearSide = diff < 0 ? Range{r.lo, mid, r.depth + 1} : Range{mid + 1, r.hi, r.depth + 1};
+            Range farSide = diff < 0 ? Range{mid + 1, r.hi, r.depth + 1} : Range{r.lo, mid, r.depth + 1};
+
+            // Far side only if the splitting line is closer than the best so far
+            // Pushed first so the near side is searched first
+            if (diff * diff <= best.first) stack.push_back(farSide);
+            stack.push_back(nearSide);
+        }
+        return best.second;
+    }
+
+    std::vector<int> SpatialIndex::kNearest(double x, double y, size_t k) const {
+        std::vector<int> result;
+        if (k == 0) return result;
+
+        std::priority_queue<Candidate> heap; // Max-heap of the k best so far
+        auto worst = [&]() {
+            return heap.size() < k ? std::numeric_limits<double>::infinity() : heap.top().first;
+        };
+
+        std::vector<Range> stack = {{0, points.size(), 0}};
+        while (!stack.empty()) {
+            Range r = stack.back();
+            stack.pop_back();
+            if (r.lo >= r.hi) continue;
+
+            size_t mid = r.lo + (r.hi - r.lo) / 2;
+            const Point& p = points[mid];
+            Candidate candidate = {squaredDistance(x, y, p.x, p.y), p.id};
+            if (heap.size() < k) {
+                heap.push(candidate);
+            } else if (candidate < heap.top()) {
+                heap.pop();
+                heap.push(candidate);
+            }
+
+            double diff = (r.depth % 2 == 0) ? x - p.x : y - p.y;
+            Range nearSide = diff < 0 ? Range{r.lo, mid, r.depth + 1} : Range{mid + 1, r.hi, r.depth + 1};
+            Range farSide = diff < 0 ? Range{mid + 1, r.hi, r.depth + 1} : Range{r.lo, mid, r.depth + 1};
+            if (diff * diff <= worst()) stack.push_back(farSide);
+            stack.push_back(nearSide);
+        }
+
+        // Heap pops worst first, so fill from the back
+        result.resize(heap.size());
+        for (size_t i = result.size(); i-- > 0;) {
+            result[i] = heap.top().second;
+            heap.pop();
+        }
+        return result;
+    }
+
+    std::vector<int> SpatialIndex::withinBox(double minX, double minY, double maxX, double maxY) const {
+        std::vector<int> result;
+
+        std::vector<Range> stack = {{0, points.size(), 0}};
+        while (!stack.empty()) {
+            Range r = stack.back();
+            stack.pop_back();
+            if (r.lo >= r.hi) continue;
+
+            size_t mid = r.lo + (r.hi - r.lo) / 2;
+            const Point& p = points[mid];
+            if (p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY) result.push_back(p.id);
+
+            // Descend only into halves that can overlap the box
+            double split = (r.depth % 2 == 0) ? p.x : p.y;
+            double low = (r.depth % 2 == 0) ? minX : minY;
+            double high = (r.depth % 2 == 0) ? maxX : maxY;
+            if (low <= split) stack.push_back({r.lo, mid, r.depth + 1});
+            if (high >= split) stack.push_back({mid + 1, r.hi, r.depth + 1});
+        }
+        return result;
+    }
+
+    std::vector<int> SpatialIndex::withinRadius(double x, double y, double radius) const {
+        std::vector<int> result;
+        const double radius2 = radius * radius;
+
+        std::vector<Range> stack = {{0, points.size(), 0}};
+        while (!stack.empty()) {
+            Range r = stack.back();
+            stack.pop_back();
+            if (r.lo >= r.hi) continue;
+
+            size_t mid = r.lo + (r.hi - r.lo) / 2;
+            const Point& p = points[mid];
+            if (squaredDistance(x, y, p.x, p.y) <= radius2) result.push_back(p.id);
+
+            double diff = (r.depth % 2 == 0) ? x - p.x : y - p.y;
+            if (diff - radius <= 0) stack.push_back({r.lo, mid, r.depth + 1});
+            if (diff + radius >= 0) stack.push_back({mid + 1, r.hi, r.depth + 1});
+        }
+        return result;
+    }
+}
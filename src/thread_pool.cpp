@@ -0,0 +1,89 @@
+#include "route_planner/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace RoutePlanner {
+    ThreadPool::ThreadPool(size_t numThreads) {
+        if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+        workers.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeup.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    void ThreadPool::workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeup.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+        if (count == 0) return;
+
+        // Shared between caller and helpers; helpers may start after the loop
+        // is finished, so the state outlives this call via shared_ptr
+        struct State {
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<State>();
+
+        // Claim indices until none are left. Completion is counted per index,
+        // not per helper, so a helper that never gets a thread can't block us
+        auto work = [state, &body, count]() {
+            size_t i;
+            while ((i = state->next.fetch_add(1)) < count) {
+                try {
+                    body(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                }
+                if (state->done.fetch_add(1) + 1 == count) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(count, workers.size() + 1) - 1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // 'body' is only touched while indices remain, all of which finish before we return
+            for (size_t h = 0; h < helpers; ++h) tasks.push(work);
+        }
+        wakeup.notify_all();
+
+        work();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&]() { return state->done.load() == count; });
+        if (state->error) std::rethrow_exception(state->error);
+    }
+
+    ThreadPool& ThreadPool::shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+}
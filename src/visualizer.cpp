@@ -1,6 +1,9 @@
 #include "route_planner/graph.hpp"
 #include "route_planner/visualizer.hpp"
 #include "route_planner/router.hpp"
+#include "route_planner/async_router.hpp"
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/spatial_index.hpp"
 #include <SFML/Graphics.hpp>
 #include <SFML/Window/Cursor.hpp>
 #include <cmath>
@@ -8,35 +11,143 @@
 #include <iostream>
 #include <algorithm>
 #include <optional>
+#include <cstdint>
+#include <string_view>
 
 namespace RoutePlanner {
+    namespace {
+        // Past this many nodes, static labels would be an unreadable wall of text,
+        // so only the hovered node gets one
+        constexpr size_t MAX_LABELED_NODES = 20000;
+
+        constexpr float NODE_RADIUS = 7.f;
+        constexpr unsigned LABEL_SIZE = 14;
+
+        // Geometry that is uploaded once and drawn with a single call
+        // Lives in a GPU vertex buffer when supported, else in a client-side array
+        class StaticMesh {
+        public:
+            explicit StaticMesh(sf::PrimitiveType type)
+                : vertices(type), buffer(type, sf::VertexBuffer::Usage::Static) {}
+
+            void append(const sf::Vertex& vertex) { vertices.append(vertex); }
+
+            // Call once after the last append()
+            void upload() {
+                if (vertices.getVertexCount() == 0 || !sf::VertexBuffer::isAvailable()) return;
+                if (buffer.create(vertices.getVertexCount()) && buffer.update(&vertices[0])) {
+                    onGpu = true;
+                    vertices.clear();
+                }
+            }
+
+            void draw(sf::RenderTarget& target, const sf::RenderStates& states = sf::RenderStates::Default) const {
+                if (onGpu) target.draw(buffer, states);
+                else target.draw(vertices, states);
+            }
+
+        private:
+            sf::VertexArray vertices;
+            sf::VertexBuffer buffer;
+            bool onGpu = false;
+        };
+
+        // Smooth white disc, tinted per vertex, so every node is one textured quad
+        sf::Texture makeDiscTexture() {
+            const unsigned size = 32;
+            const float radius = size / 2.f;
+            sf::Image image({size, size}, sf::Color::Transparent);
+            for (unsigned y = 0; y < size; ++y) {
+                for (unsigned x = 0; x < size; ++x) {
+                    float dist = std::hypot(x + 0.5f - radius, y + 0.5f - radius);
+                    float alpha = std::clamp(radius - dist, 0.f, 1.f); // 1px antialiased rim
+                    image.setPixel({x, y}, sf::Color(255, 255, 255, static_cast<std::uint8_t>(alpha * 255)));
+                }
+            }
+            sf::Texture texture;
+            if (texture.loadFromImage(image)) texture.setSmooth(true);
+            return texture;
+        }
+
+        // Two triangles covering [topLeft, topLeft + size], mapped onto texRect
+        void appendQuad(StaticMesh& mesh, sf::Vector2f topLeft, sf::Vector2f size,
+                        sf::Vector2f texTopLeft, sf::Vector2f texSize, sf::Color color) {
+            sf::Vector2f topRight = topLeft + sf::Vector2f(size.x, 0.f);
+            sf::Vector2f bottomLeft = topLeft + sf::Vector2f(0.f, size.y);
+            sf::Vector2f bottomRight = topLeft + size;
+            sf::Vector2f texTopRight = texTopLeft + sf::Vector2f(texSize.x, 0.f);
+            sf::Vector2f texBottomLeft = texTopLeft + sf::Vector2f(0.f, texSize.y);
+            sf::Vector2f texBottomRight = texTopLeft + texSize;
+            mesh.append({topLeft, color, texTopLeft});
+            mesh.append({topRight, color, texTopRight});
+            mesh.append({bottomLeft, color, texBottomLeft});
+            mesh.append({bottomLeft, color, texBottomLeft});
+            mesh.append({topRight, color, texTopRight});
+            mesh.append({bottomRight, color, texBottomRight});
+        }
+
+        // Lay out 'text' like sf::Text would, but into a shared mesh
+        // Glyphs come from the font's own cache, so all labels share one texture
+        void appendLabel(StaticMesh& mesh, const sf::Font& font, std::string_view text, sf::Vector2f position) {
+            float x = position.x;
+            float baseline = position.y + LABEL_SIZE;
+            char32_t previous = 0;
+            for (unsigned char c : text) {
+                x += font.getKerning(previous, c, LABEL_SIZE);
+                previous = c;
+                const sf::Glyph& glyph = font.getGlyph(c, LABEL_SIZE, false);
+                sf::Vector2f topLeft(x + glyph.bounds.position.x, baseline + glyph.bounds.position.y);
+                appendQuad(mesh, topLeft, glyph.bounds.size,
+                           sf::Vector2f(glyph.textureRect.position), sf::Vector2f(glyph.textureRect.size),
+                           sf::Color::Yellow);
+                x += glyph.advance;
+            }
+        }
+    }
+
     void displaySFML(const Graph& graph) {
+        displaySFML(graph.freeze());
+    }
+
+    void displaySFML(const CompactGraph& graph) {
         // Add antialiasing to make it smoother
         sf::ContextSettings settings;
         settings.antiAliasingLevel = 8; // higher = smoother
 
         sf::RenderWindow window(sf::VideoMode({800, 600}), "Route Planner", sf::State::Windowed, settings);
+        window.setFramerateLimit(60);
 
         sf::Font font;
-        if (!font.openFromFile("assets/font.ttf")) {
-            if (!font.openFromFile("../assets/font.ttf")) {
+        bool fontLoaded = font.openFromFile("assets/font.ttf");
+        if (!fontLoaded) {
+            fontLoaded = font.openFromFile("../assets/font.ttf");
+            if (!fontLoaded) {
                 std::cerr << "Error: Could not load font.ttf from assets folder" << std::endl;
             }
         }
 
+        // Cursors are created once; the window only keeps a reference
+        const auto handCursor = sf::Cursor::createFromSystem(sf::Cursor::Type::Hand);
+        const auto arrowCursor = sf::Cursor::createFromSystem(sf::Cursor::Type::Arrow);
+
         // Selection state
         int startNodeId = -1;
         int endNodeId = -1;
         int hoveredNodeId = -1;
         std::vector<int> currentPath;
 
+        // Routes are computed on a worker so the window keeps drawing; a new click
+        // supersedes the query in flight. Nodes it expands are drawn as they come in
+        AsyncRouter router(graph);
+        RouteHandle pendingRoute;
+
         // Find bounds. Same logic as ASCII, but pixels now
         double minX = 1e9, maxX = -1e9, minY = 1e9, maxY = -1e9;
-        for (const auto& [id, node] : graph.getAllNodes()) {
-            minX = std::min(minX, node.x);
-            maxX = std::max(maxX, node.x);
-            minY = std::min(minY, node.y);
-            maxY = std::max(maxY, node.y);
+        for (size_t i = 0; i < graph.numNodes(); ++i) {
+            minX = std::min(minX, graph.x(i));
+            maxX = std::max(maxX, graph.x(i));
+            minY = std::min(minY, graph.y(i));
+            maxY = std::max(maxY, graph.y(i));
         }
 
         // Add padding so nodes not on very edge
@@ -47,6 +158,90 @@ namespace RoutePlanner {
             return sf::Vector2f(px, py);
         };
 
+        // Node under a pixel position, -1 if none within 'radius' pixels
+        // The index works in map units, so query the map-space box around the
+        // hit circle and measure the few candidates in pixels
+        const SpatialIndex spatial(graph);
+        const double unitsPerPixelX = (maxX - minX) / (800 - 2 * padding);
+        const double unitsPerPixelY = (maxY - minY) / (600 - 2 * padding);
+        auto pickNode = [&](sf::Vector2f pos, float radius) {
+            double mapX = minX + (pos.x - padding) * unitsPerPixelX;
+            double mapY = minY + ((600 - padding) - pos.y) * unitsPerPixelY;
+            int picked = -1;
+            float pickedDist = radius;
+            for (int id : spatial.withinBox(mapX - radius * unitsPerPixelX, mapY - radius * unitsPerPixelY,
+                                            mapX + radius * unitsPerPixelX, mapY + radius * unitsPerPixelY)) {
+                int i = graph.indexOf(id);
+                sf::Vector2f nodePos = toPixel(graph.x(i), graph.y(i));
+                float dist = std::hypot(pos.x - nodePos.x, pos.y - nodePos.y);
+                if (dist < pickedDist || (dist == pickedDist && picked != -1 && id < picked)) {
+                    picked = id;
+                    pickedDist = dist;
+                }
+            }
+            return picked;
+        };
+
+        // Bake the static scene once: edges, node discs and labels
+        // Two-way roads are stored as two edges but drawn as one line
+        StaticMesh edgeMesh(sf::PrimitiveType::Lines);
+        for (size_t u = 0; u < graph.numNodes(); ++u) {
+            for (uint32_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+                int v = graph.target(e);
+                if (static_cast<size_t>(v) < u) {
+                    bool hasReverse = false;
+                    for (uint32_t r = graph.edgeBegin(v); r < graph.edgeEnd(v) && !hasReverse; ++r) {
+                        hasReverse = graph.target(r) == static_cast<int>(u);
+                    }
+                    if (hasReverse) continue; // Already drawn from v
+                }
+                edgeMesh.append({toPixel(graph.x(u), graph.y(u)), sf::Color(100, 100, 100)});
+                edgeMesh.append({toPixel(graph.x(v), graph.y(v)), sf::Color(100, 100, 100)});
+            }
+        }
+        edgeMesh.upload();
+
+        const sf::Texture disc = makeDiscTexture();
+        const sf::Vector2f discSize(disc.getSize());
+        StaticMesh nodeMesh(sf::PrimitiveType::Triangles);
+        for (size_t i = 0; i < graph.numNodes(); ++i) {
+            sf::Vector2f pos = toPixel(graph.x(i), graph.y(i));
+            appendQuad(nodeMesh, pos - sf::Vector2f(NODE_RADIUS, NODE_RADIUS), {2 * NODE_RADIUS, 2 * NODE_RADIUS},
+                       {0.f, 0.f}, discSize, sf::Color::White);
+        }
+        nodeMesh.upload();
+
+        // Labels are offset so they don't cover the disc
+        const bool bakeLabels = fontLoaded && graph.numNodes() <= MAX_LABELED_NODES;
+        StaticMesh labelMesh(sf::PrimitiveType::Triangles);
+        if (bakeLabels) {
+            for (size_t i = 0; i < graph.numNodes(); ++i) {
+                sf::Vector2f pos = toPixel(graph.x(i), graph.y(i));
+                appendLabel(labelMesh, font, graph.name(i), {pos.x + 8.f, pos.y - 10.f});
+            }
+            labelMesh.upload();
+        }
+
+        // Dynamic state, rebuilt only when the selection or hover changes
+        sf::VertexArray pathLines(sf::PrimitiveType::LineStrip);
+        sf::VertexArray frontier(sf::PrimitiveType::Points); // Grows while a route computes
+        std::optional<sf::Text> hoverLabel;
+        int labeledNodeId = -1;
+
+        // Start node is green, end is red; hovered node gets a cyan outline
+        auto drawHighlight = [&](int id, sf::Color fill, bool outline) {
+            int i = graph.indexOf(id);
+            sf::CircleShape circle(NODE_RADIUS);
+            circle.setOrigin({NODE_RADIUS, NODE_RADIUS});
+            circle.setPosition(toPixel(graph.x(i), graph.y(i)));
+            circle.setFillColor(fill);
+            if (outline) {
+                circle.setOutlineThickness(2.f);
+                circle.setOutlineColor(sf::Color::Cyan);
+            }
+            window.draw(circle);
+        };
+
         while (window.isOpen()) {
             while (const std::optional event = window.pollEvent()) {
                 if (event->is<sf::Event::Closed>()) window.close();
@@ -64,114 +259,98 @@ namespace RoutePlanner {
                     sf::Vector2f worldPos = window.mapPixelToCoords(mousePos);
 
                     // Find which node was clicked
-                    for (const auto& [id, node] : graph.getAllNodes()) {
-                        sf::Vector2f nodePos = toPixel(node.x, node.y);
-                        float dist = std::sqrt(std::pow(worldPos.x - nodePos.x, 2) + std::pow(worldPos.y - nodePos.y, 2));
-
-                        if (dist < 10.0f) { // 10 pixel hit box
-                            if (startNodeId == -1 || (startNodeId != -1 && endNodeId != -1)) {
-                                startNodeId = id;
-                                endNodeId = -1;
-                                currentPath.clear();
-                            } else {
-                                endNodeId = id;
-                                // Calc route immediately
-                                auto result = Router::computePath(graph, startNodeId, endNodeId);
-                                if (result.success) {
-                                    currentPath = result.path;
-                            }
-                            break;
+                    int id = pickNode(worldPos, 10.0f); // 10 pixel hit box
+                    if (id != -1) {
+                        if (startNodeId == -1 || (startNodeId != -1 && endNodeId != -1)) {
+                            startNodeId = id;
+                            endNodeId = -1;
+                            router.cancel(); // Nobody wants the old route any more
+                            pendingRoute = RouteHandle();
+                        } else {
+                            endNodeId = id;
+                            pendingRoute = router.submit(startNodeId, endNodeId);
                         }
+                        currentPath.clear();
+                        pathLines.clear();
+                        frontier.clear();
                     }
                 }
             }
 
-            // Handle Hover Logic (Every Frame)
-            auto mousePos = sf::Mouse::getPosition(window);
-            sf::Vector2f worldPos = window.mapPixelToCoords(mousePos);
-            
-            hoveredNodeId = -1; // Reset each frame
-            for (const auto& [id, node] : graph.getAllNodes()) {
-                sf::Vector2f nodePos = toPixel(node.x, node.y);
-                float dist = std::sqrt(std::pow(worldPos.x - nodePos.x, 2) + std::pow(worldPos.y - nodePos.y, 2));
-
-                if (dist < 12.0f) { // Slightly larger hitbox for hovering
-                    hoveredNodeId = id;
-                    break; 
+            // Pick up search progress, and the route once it is done
+            if (pendingRoute.valid()) {
+                for (int id : pendingRoute.takeProgress()) {
+                    int i = graph.indexOf(id);
+                    frontier.append({toPixel(graph.x(i), graph.y(i)), sf::Color(255, 165, 0)});
+                }
+                if (pendingRoute.ready()) {
+                    auto result = pendingRoute.get();
+                    if (result.success) {
+                        currentPath = result.path;
+                    }
+                    pendingRoute = RouteHandle();
+                    frontier.clear();
+
+                    // Rebuild the highlighted path
+                    for (int pathId : currentPath) {
+                        int i = graph.indexOf(pathId);
+                        pathLines.append({toPixel(graph.x(i), graph.y(i)), sf::Color::Cyan});
+                    }
                 }
-            }
-            if (hoveredNodeId != -1) {
-                const auto cursor = sf::Cursor::createFromSystem(sf::Cursor::Type::Hand).value();
-                window.setMouseCursor(cursor);
-            } else {
-                const auto cursor = sf::Cursor::createFromSystem(sf::Cursor::Type::Arrow).value();
-                window.setMouseCursor(cursor);
             }
 
-            window.clear(sf::Color(30,30,30)); // Dark grey
+            // Handle Hover Logic (Every Frame)
+            auto mousePos = sf::Mouse::getPosition(window);
+            sf::Vector2f worldPos = window.mapPixelToCoords(mousePos);
 
-            // Draw ALL edges
-            for (const auto& [id, node] : graph.getAllNodes()) {
-                for (const auto& edge : node.neighbors) {
-                    const Node* target = graph.getNode(edge.targetNodeID);
-                    sf::Vertex line[] = {
-                        {toPixel(node.x, node.y), sf::Color(100, 100, 100)},
-                        {toPixel(target->x, target->y), sf::Color(100, 100, 100)}
-                    };
-                window.draw(line, 2, sf::PrimitiveType::Lines);
-                }
+            int hovered = pickNode(worldPos, 12.0f); // Slightly larger hitbox for hovering
+            if ((hovered != -1) != (hoveredNodeId != -1)) {
+                // Only touch the cursor when it actually changes
+                const auto& cursor = hovered != -1 ? handCursor : arrowCursor;
+                if (cursor) window.setMouseCursor(*cursor);
             }
+            hoveredNodeId = hovered;
 
-            // Draw the Path (highlighted)
-            if (!currentPath.empty()) {
-                for (size_t i = 0; i < currentPath.size() - 1; ++i) {
-                    const Node* start = graph.getNode(currentPath[i]);
-                    const Node* end = graph.getNode(currentPath[i + 1]);
-                    sf::Vertex line[] = {
-                        {toPixel(start->x, start->y), sf::Color::Cyan},
-                        {toPixel(end->x, end->y), sf::Color::Cyan}
-                    };
-                    window.draw(line, 2, sf::PrimitiveType::Lines);
+            if (!bakeLabels && fontLoaded && hoveredNodeId != labeledNodeId) {
+                hoverLabel.reset();
+                if (hoveredNodeId != -1) {
+                    int i = graph.indexOf(hoveredNodeId);
+                    sf::Vector2f pos = toPixel(graph.x(i), graph.y(i));
+                    hoverLabel.emplace(font, std::string(graph.name(i)), LABEL_SIZE);
+                    hoverLabel->setFillColor(sf::Color::Yellow);
+                    hoverLabel->setPosition({pos.x + 8.f, pos.y - 10.f});
                 }
+                labeledNodeId = hoveredNodeId;
             }
 
-            // Draw Nodes
-            for (const auto& [id, node] : graph.getAllNodes()) {
-                sf::Vector2f pos = toPixel(node.x, node.y);
-
-                // Draw node dot
-                sf::CircleShape circle(7.f);
-                circle.setOrigin({7.f, 7.f});
-                circle.setPosition(toPixel(node.x, node.y));
-
-                circle.setFillColor(sf::Color::White);
-                // Start node is green, end is red, others white
-                if(!currentPath.empty()) {
-                    if(id== currentPath.front()) circle.setFillColor(sf::Color::Green);
-                    else if(id== currentPath.back()) circle.setFillColor(sf::Color::Red);
-                }
+            window.clear(sf::Color(30,30,30)); // Dark grey
 
-                // Add outline to hovered node
-                if (id == hoveredNodeId) {
-                    circle.setOutlineThickness(2.f);
-                    circle.setOutlineColor(sf::Color::Cyan);
-                }
-                
-                window.draw(circle);
+            edgeMesh.draw(window);
+            window.draw(frontier);
+            window.draw(pathLines);
 
-                // Draw label
-                sf::Text label(font, node.name, 14); // font, string, size
-                label.setFillColor(sf::Color::Yellow);
+            sf::RenderStates discStates;
+            discStates.texture = &disc;
+            nodeMesh.draw(window, discStates);
 
-                // Offset text so no overlap
-                label.setPosition({pos.x + 8.f, pos.y - 10.f});
+            // Overlays for the few nodes that differ from the baked ones
+            // Selection shows right away, before the route is in
+            if (startNodeId != -1) drawHighlight(startNodeId, sf::Color::Green, startNodeId == hoveredNodeId);
+            if (endNodeId != -1) drawHighlight(endNodeId, sf::Color::Red, endNodeId == hoveredNodeId);
+            if (hoveredNodeId != -1 && hoveredNodeId != startNodeId && hoveredNodeId != endNodeId) {
+                drawHighlight(hoveredNodeId, sf::Color::White, true);
+            }
 
-                window.draw(label);
+            if (bakeLabels) {
+                sf::RenderStates glyphStates;
+                glyphStates.texture = &font.getTexture(LABEL_SIZE);
+                labelMesh.draw(window, glyphStates);
+            } else if (hoverLabel) {
+                window.draw(*hoverLabel);
             }
             window.display();
         }
     }
-    }
 
     void drawAsciiMap(const Graph& graph, const std::vector<int>& path) {
         const int WIDTH = 50;
@@ -1,6 +1,35 @@
 #include <gtest/gtest.h>
 #include "route_planner/graph.hpp"
 #include "route_planner/router.hpp"
+#include "route_planner/basic_router.hpp"
+#include "route_planner/compact_graph.hpp"
+#include "route_planner/compressed_graph.hpp"
+#include "route_planner/async_router.hpp"
+#include "route_planner/distance_kernels.hpp"
+#include "route_planner/search_context.hpp"
+#include "route_planner/contraction_hierarchy.hpp"
+#include "route_planner/hub_labels.hpp"
+#include "route_planner/landmarks.hpp"
+#include "route_planner/thread_pool.hpp"
+#include "route_planner/map_loader.hpp"
+#include "route_planner/name_index.hpp"
+#include "route_planner/spatial_index.hpp"
+#include "route_planner/generators.hpp"
+#include "route_planner/route_cache.hpp"
+#include "route_planner/live_graph.hpp"
+#include "route_planner/route_server.hpp"
+#include "route_planner/node_order.hpp"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <set>
+#include <functional>
+#include <random>
+#include <cstdio>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <atomic>
 
 using namespace RoutePlanner;
 
@@ -110,4 +139,1193 @@ TEST(GraphTest, AddNodeAndEdge) {
     ASSERT_NE(n, nullptr); // Ensure pointer isn't null
     EXPECT_EQ(n->name, "Test");
     EXPECT_EQ(n->neighbors.size(), 1);
-}
\ No newline at end of file
+}
+
+// Test CompactGraph: dense remap and CSR layout
+TEST(CompactGraphTest, FreezeLayout) {
+    Graph g;
+    g.addNode(30, "C", 2.0, 0.0);
+    g.addNode(10, "A", 0.0, 0.0);
+    g.addNode(20, "B", 1.0, 0.0);
+    g.addEdge(10, 20, 1.5);
+    g.addEdge(10, 30, 4.0);
+    g.addEdge(20, 30, 2.0);
+    g.addEdge(20, 99, 1.0); // Dangling target gets dropped
+
+    CompactGraph cg = g.freeze();
+
+    ASSERT_EQ(cg.numNodes(), 3);
+    EXPECT_EQ(cg.numEdges(), 3);
+    EXPECT_EQ(cg.indexOf(10), 0);
+    EXPECT_EQ(cg.indexOf(30), 2);
+    EXPECT_EQ(cg.indexOf(99), -1);
+    EXPECT_EQ(cg.idOf(1), 20);
+    EXPECT_EQ(cg.name(2), "C");
+    EXPECT_DOUBLE_EQ(cg.x(2), 2.0);
+
+    int a = cg.indexOf(10);
+    ASSERT_EQ(cg.degree(a), 2);
+    EXPECT_EQ(cg.idOf(cg.target(cg.edgeBegin(a))), 20);
+    EXPECT_DOUBLE_EQ(cg.weight(cg.edgeBegin(a)), 1.5);
+}
+
+// Frozen router must agree with the hash-map router
+TEST(CompactGraphTest, RouterMatchesGraph) {
+    Graph g;
+    g.addNode(1, "Start", 0, 0);
+    g.addNode(2, "Middle", 0, 0);
+    g.addNode(3, "End", 0, 0);
+    g.addEdge(1, 3, 10.0);
+    g.addEdge(1, 2, 2.0);
+    g.addEdge(2, 3, 2.0);
+
+    CompactGraph cg = g.freeze();
+    auto expected = Router::computePath(g, 1, 3);
+    auto result = Router::computePath(cg, 1, 3);
+
+    EXPECT_TRUE(result.success);
+    EXPECT_DOUBLE_EQ(result.totalDist, expected.totalDist);
+    EXPECT_EQ(result.path, expected.path);
+
+    EXPECT_FALSE(Router::computePath(cg, 3, 1).success); // One-way edges
+    EXPECT_FALSE(Router::computePath(cg, 1, 42).success); // Unknown ID
+    EXPECT_EQ(Router::computePath(cg, 2, 2).path.size(), 1);
+}
+
+// One context reused across queries and graphs of different sizes
+TEST(SearchContextTest, ReuseAcrossQueries) {
+    Graph g;
+    for (int i = 1; i <= 5; ++i) g.addNode(i, "N", i, 0);
+    for (int i = 1; i < 5; ++i) {
+        g.addEdge(i, i + 1, 1.0);
+        g.addEdge(i + 1, i, 1.0);
+    }
+    CompactGraph cg = g.freeze();
+
+    SearchContext ctx;
+    auto first = Router::computePath(cg, 1, 5, ctx);
+    EXPECT_TRUE(first.success);
+    EXPECT_DOUBLE_EQ(first.totalDist, 4.0);
+
+    // Earlier distances must not leak into the next query
+    auto second = Router::computePath(cg, 5, 2, ctx);
+    EXPECT_TRUE(second.success);
+    EXPECT_DOUBLE_EQ(second.totalDist, 3.0);
+    EXPECT_EQ(second.path, (std::vector<int>{5, 4, 3, 2}));
+
+    Graph small;
+    small.addNode(7, "X", 0, 0);
+    small.addNode(8, "Y", 1, 0);
+    auto third = Router::computePath(small.freeze(), 7, 8, ctx);
+    EXPECT_FALSE(third.success);
+    EXPECT_EQ(ctx.capacity(), 5);
+}
+
+// Random directed graph with asymmetric weights for cross-checking engines
+// Coords stay within a 0.5 box so every edge (>= 1.0) outweighs the Euclidean
+// heuristic, keeping Router's A* exact
+static Graph makeRandomGraph(int numNodes, int numEdges, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coord(0.0, 0.5);
+    std::uniform_real_distribution<double> weight(1.0, 20.0);
+    std::uniform_int_distribution<int> pick(1, numNodes);
+
+    Graph g;
+    for (int i = 1; i <= numNodes; ++i) g.addNode(i, "N" + std::to_string(i), coord(rng), coord(rng));
+    for (int i = 0; i < numEdges; ++i) g.addEdge(pick(rng), pick(rng), weight(rng));
+    return g;
+}
+
+// Path must follow existing edges and add up to the reported distance
+static double pathLength(const Graph& g, const std::vector<int>& path) {
+    double total = 0.0;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        double best = -1.0;
+        for (const auto& edge : g.getNode(path[i])->neighbors) {
+            if (edge.targetNodeID == path[i + 1] && (best < 0 || edge.distance < best)) best = edge.distance;
+        }
+        if (best < 0) return -1.0;
+        total += best;
+    }
+    return total;
+}
+
+// CH queries must match plain Dijkstra/A* on every pair
+TEST(ContractionHierarchyTest, MatchesDijkstra) {
+    Graph g = makeRandomGraph(60, 200, 7);
+    CompactGraph cg = g.freeze();
+    ContractionHierarchy ch = ContractionHierarchy::build(cg);
+
+    ASSERT_EQ(ch.numNodes(), 60);
+    for (int s = 1; s <= 60; s += 3) {
+        for (int t = 1; t <= 60; t += 2) {
+            auto expected = Router::computePath(cg, s, t);
+            auto result = ch.query(s, t);
+            ASSERT_EQ(result.success, expected.success) << s << " -> " << t;
+            if (!result.success) continue;
+            EXPECT_NEAR(result.totalDist, expected.totalDist, 1e-9);
+            EXPECT_EQ(result.path.front(), s);
+            EXPECT_EQ(result.path.back(), t);
+            EXPECT_NEAR(pathLength(g, result.path), result.totalDist, 1e-9);
+        }
+    }
+}
+
+// Saved hierarchy answers the same as the original
+TEST(ContractionHierarchyTest, SaveAndLoad) {
+    Graph g = makeRandomGraph(40, 120, 11);
+    ContractionHierarchy ch = ContractionHierarchy::build(g.freeze());
+
+    std::string path = ::testing::TempDir() + "route_planner_test.ch";
+    ASSERT_TRUE(ch.save(path));
+
+    ContractionHierarchy loaded;
+    ASSERT_TRUE(ContractionHierarchy::load(path, loaded));
+    EXPECT_EQ(loaded.numShortcuts(), ch.numShortcuts());
+    for (int t = 1; t <= 40; ++t) {
+        auto a = ch.query(1, t);
+        auto b = loaded.query(1, t);
+        EXPECT_EQ(a.success, b.success);
+        EXPECT_EQ(a.path, b.path);
+    }
+
+    // Header count far past the file, then an arc pointing at a node that doesn't exist
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const uint64_t huge = uint64_t(1) << 60;
+        file.seekp(8 + sizeof(uint64_t)); // Forward arc count
+        file.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    }
+    EXPECT_FALSE(ContractionHierarchy::load(path, loaded));
+    ASSERT_TRUE(ch.save(path));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const int bad = 1 << 30;
+        file.seekp(40 + 2 * 40 * sizeof(int) + 41 * sizeof(uint32_t)); // First forward arc's node
+        file.write(reinterpret_cast<const char*>(&bad), sizeof(bad));
+    }
+    EXPECT_FALSE(ContractionHierarchy::load(path, loaded));
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(ContractionHierarchy::load(path, loaded));
+}
+
+// Label merges give Dijkstra's distances, parent hubs rebuild a valid path, and a saved index answers the same
+TEST(HubLabelsTest, MatchesDijkstraAndRoundTrips) {
+    Graph g = makeRandomGraph(60, 200, 13);
+    CompactGraph cg = g.freeze();
+    HubLabels labels = HubLabels::build(cg);
+
+    std::string path = ::testing::TempDir() + "route_planner_test.hl";
+    ASSERT_TRUE(labels.save(path));
+    HubLabels loaded;
+    ASSERT_TRUE(HubLabels::load(path, loaded));
+    std::remove(path.c_str());
+    EXPECT_EQ(loaded.numEntries(), labels.numEntries());
+
+    ASSERT_EQ(labels.numNodes(), 60);
+    for (int s = 1; s <= 60; s += 3) {
+        for (int t = 1; t <= 60; ++t) {
+            auto expected = Router::computePath(cg, s, t);
+            auto result = loaded.query(s, t);
+            ASSERT_EQ(result.success, expected.success) << s << " -> " << t;
+            if (!result.success) {
+                EXPECT_TRUE(std::isinf(labels.distance(s, t)));
+                continue;
+            }
+            EXPECT_NEAR(labels.distance(s, t), expected.totalDist, 1e-9);
+            EXPECT_NEAR(result.totalDist, expected.totalDist, 1e-9);
+            EXPECT_EQ(result.path.front(), s);
+            EXPECT_EQ(result.path.back(), t);
+            EXPECT_NEAR(pathLength(g, result.path), result.totalDist, 1e-9);
+        }
+    }
+    EXPECT_TRUE(std::isinf(labels.distance(1, 999)));
+    EXPECT_FALSE(HubLabels::load(path, loaded));
+
+    // Corrupt header sizes and out-of-range parents are rejected, not allocated or followed
+    ASSERT_TRUE(labels.save(path));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const uint64_t huge = uint64_t(1) << 60;
+        file.seekp(8 + sizeof(uint64_t)); // Out-label entry count
+        file.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    }
+    EXPECT_FALSE(HubLabels::load(path, loaded));
+    ASSERT_TRUE(labels.save(path));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-static_cast<std::streamoff>(sizeof(int)), std::ios::end); // Last in-label parent
+        const int bad = 1 << 30;
+        file.write(reinterpret_cast<const char*>(&bad), sizeof(bad));
+    }
+    EXPECT_FALSE(HubLabels::load(path, loaded));
+    std::remove(path.c_str());
+}
+
+// Landmark bounds never overestimate, and ALT routes match Dijkstra
+TEST(LandmarksTest, AltMatchesDijkstra) {
+    Graph g = makeRandomGraph(80, 300, 23);
+    CompactGraph cg = g.freeze();
+
+    for (auto strategy : {LandmarkStrategy::Farthest, LandmarkStrategy::Avoid}) {
+        Landmarks lm = Landmarks::select(cg, 4, strategy);
+        ASSERT_EQ(lm.size(), 4);
+
+        RouteOptions dijkstra;
+        dijkstra.heuristic = HeuristicType::Zero;
+        RouteOptions alt;
+        alt.heuristic = HeuristicType::Landmark;
+        alt.landmarks = &lm;
+
+        for (int s = 1; s <= 80; s += 7) {
+            for (int t = 1; t <= 80; t += 3) {
+                auto expected = Router::computePath(cg, s, t, dijkstra);
+                auto result = Router::computePath(cg, s, t, alt);
+                ASSERT_EQ(result.success, expected.success);
+                if (!result.success) continue;
+                EXPECT_NEAR(result.totalDist, expected.totalDist, 1e-9);
+                EXPECT_LE(lm.lowerBound(cg.indexOf(s), cg.indexOf(t)), expected.totalDist + 1e-9);
+            }
+        }
+    }
+}
+
+// Landmarks from another graph must be rejected
+TEST(LandmarksTest, MismatchedGraphThrows) {
+    Graph g = makeRandomGraph(10, 30, 5);
+    Landmarks lm = Landmarks::select(makeRandomGraph(12, 30, 5).freeze(), 2);
+
+    RouteOptions alt;
+    alt.heuristic = HeuristicType::Landmark;
+    alt.landmarks = &lm;
+    EXPECT_THROW(Router::computePath(g.freeze(), 1, 2, alt), std::invalid_argument);
+}
+
+// Bidirectional search agrees with Dijkstra on one-way edges for every heuristic
+TEST(RouterTest, BidirectionalMatchesDijkstra) {
+    Graph g = makeRandomGraph(80, 250, 31);
+    CompactGraph cg = g.freeze();
+    Landmarks lm = Landmarks::select(cg, 3);
+
+    RouteOptions dijkstra;
+    dijkstra.heuristic = HeuristicType::Zero;
+
+    for (auto heuristic : {HeuristicType::Zero, HeuristicType::Euclidean, HeuristicType::Landmark}) {
+        RouteOptions options;
+        options.heuristic = heuristic;
+        options.landmarks = &lm;
+        options.bidirectional = true;
+
+        for (int s = 1; s <= 80; s += 5) {
+            for (int t = 1; t <= 80; t += 3) {
+                auto expected = Router::computePath(cg, s, t, dijkstra);
+                auto result = Router::computePath(cg, s, t, options);
+                ASSERT_EQ(result.success, expected.success) << s << " -> " << t;
+                if (!result.success) continue;
+                EXPECT_NEAR(result.totalDist, expected.totalDist, 1e-9);
+                EXPECT_EQ(result.path.front(), s);
+                EXPECT_EQ(result.path.back(), t);
+                EXPECT_NEAR(pathLength(g, result.path), result.totalDist, 1e-9);
+            }
+        }
+    }
+}
+
+// Matrix entries match single queries, in parallel
+TEST(DistanceMatrixTest, MatchesSingleQueries) {
+    Graph g = makeRandomGraph(70, 220, 41);
+    CompactGraph cg = g.freeze();
+    std::vector<int> sources = {1, 5, 9, 13, 70, 999};
+    std::vector<int> targets = {2, 3, 5, 5, 40, 68, -7};
+
+    ThreadPool pool(3);
+    DistanceMatrix m = Router::distanceMatrix(cg, sources, targets, true, &pool);
+    ASSERT_EQ(m.rows, sources.size());
+    ASSERT_EQ(m.cols, targets.size());
+
+    RouteOptions dijkstra;
+    dijkstra.heuristic = HeuristicType::Zero;
+    for (size_t r = 0; r < m.rows; ++r) {
+        for (size_t c = 0; c < m.cols; ++c) {
+            auto expected = Router::computePath(cg, sources[r], targets[c], dijkstra);
+            if (!expected.success) {
+                EXPECT_TRUE(std::isinf(m.at(r, c)));
+                EXPECT_TRUE(m.path(r, c).empty());
+                continue;
+            }
+            EXPECT_NEAR(m.at(r, c), expected.totalDist, 1e-9);
+            EXPECT_NEAR(pathLength(g, m.path(r, c)), m.at(r, c), 1e-9);
+        }
+    }
+}
+
+// Pool runs every index once and surfaces task exceptions
+TEST(ThreadPoolTest, ParallelForAndSubmit) {
+    ThreadPool pool(4);
+    std::vector<int> hits(1000, 0);
+    pool.parallelFor(hits.size(), [&](size_t i) { hits[i]++; });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 1000);
+
+    EXPECT_EQ(pool.submit([]() { return 42; }).get(), 42);
+    EXPECT_THROW(pool.parallelFor(10, [](size_t i) { if (i == 7) throw std::runtime_error("boom"); }),
+                 std::runtime_error);
+}
+
+// Loader keeps good lines, reports bad ones with line numbers
+TEST(MapLoaderTest, ParsesAndReportsErrors) {
+    std::string nodesPath = ::testing::TempDir() + "route_planner_nodes.csv";
+    std::string edgesPath = ::testing::TempDir() + "route_planner_edges.csv";
+    {
+        std::ofstream nodes(nodesPath);
+        nodes << "# id, name, x, y\n"
+              << "1,Central Station,0,10\r\n"
+              << "2, Coffee Shop , 5.5, -8\n"
+              << "x,Broken,1,1\n"
+              << "\n"
+              << "3,Park,10,oops\n"
+              << "4,Library,2,5"; // No trailing newline
+        std::ofstream edges(edgesPath);
+        edges << "# start_node_id, end_node_id, distance\n"
+              << "1, 2, 3.6\n"
+              << "2, 4, 3.2\n"
+              << "4, 99, 1.0\n"
+              << "1, 4\n";
+    }
+
+    Graph g;
+    std::vector<ParseError> errors;
+    ASSERT_TRUE(MapLoader::loadNodes(nodesPath, g, &errors));
+    ASSERT_EQ(g.getAllNodes().size(), 3);
+    EXPECT_EQ(g.getNode(2)->name, "coffee shop");
+    EXPECT_DOUBLE_EQ(g.getNode(2)->x, 5.5);
+    EXPECT_DOUBLE_EQ(g.getNode(2)->y, -8.0);
+    EXPECT_DOUBLE_EQ(g.getNode(1)->y, 10.0);
+    ASSERT_EQ(errors.size(), 2);
+    EXPECT_EQ(errors[0].line, 4);
+    EXPECT_EQ(errors[1].line, 6);
+
+    errors.clear();
+    ASSERT_TRUE(MapLoader::loadEdges(edgesPath, g, &errors));
+    EXPECT_EQ(g.getNode(1)->neighbors.size(), 1);
+    EXPECT_EQ(g.getNode(4)->neighbors.size(), 1); // 4 -> 99 rejected whole
+    ASSERT_EQ(errors.size(), 2);
+    EXPECT_EQ(errors[0].line, 4);
+    EXPECT_EQ(errors[1].line, 5);
+
+    EXPECT_FALSE(MapLoader::loadNodes(nodesPath + ".missing", g));
+    std::remove(nodesPath.c_str());
+    std::remove(edgesPath.c_str());
+}
+// Snapshot round trip is byte-identical, corruption is caught
+TEST(SnapshotTest, SaveLoadAndChecksum) {
+    Graph g = makeRandomGraph(200, 800, 11);
+    CompactGraph cg = g.freeze();
+    std::string path = ::testing::TempDir() + "route_planner_graph.snap";
+    ASSERT_TRUE(cg.save(path));
+
+    CompactGraph loaded;
+    ASSERT_TRUE(CompactGraph::load(path, loaded));
+    ASSERT_EQ(loaded.numNodes(), cg.numNodes());
+    ASSERT_EQ(loaded.numEdges(), cg.numEdges());
+    for (size_t i = 0; i < cg.numNodes(); ++i) {
+        EXPECT_EQ(loaded.idOf(i), cg.idOf(i));
+        EXPECT_EQ(loaded.name(i), cg.name(i));
+        EXPECT_EQ(loaded.x(i), cg.x(i));
+        EXPECT_EQ(loaded.inEdgeEnd(i), cg.inEdgeEnd(i));
+    }
+    auto a = Router::computePath(cg, 1, 150);
+    auto b = Router::computePath(loaded, 1, 150);
+    EXPECT_EQ(a.path, b.path);
+
+    // Copies share the mapping and outlive the original
+    CompactGraph copy = loaded;
+    loaded = CompactGraph();
+    EXPECT_EQ(copy.name(3), cg.name(3));
+
+    // Flip a byte in the last section
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(-4, std::ios::end);
+        char c = 0;
+        file.read(&c, 1);
+        c ^= 0x5a;
+        file.seekp(-4, std::ios::end);
+        file.write(&c, 1);
+    }
+    CompactGraph corrupt;
+    EXPECT_FALSE(CompactGraph::load(path, corrupt));
+    EXPECT_TRUE(CompactGraph::load(path, corrupt, false)); // Structure is still intact
+
+    // Edge target out of range: caught without the checksum too
+    {
+        ASSERT_TRUE(cg.save(path));
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t sectionCount = 0;
+        file.seekg(12);
+        file.read(reinterpret_cast<char*>(&sectionCount), sizeof(sectionCount));
+        for (uint32_t s = 0; s < sectionCount; ++s) {
+            uint32_t tag = 0;
+            uint64_t offset = 0;
+            file.seekg(48 + 24 * s);
+            file.read(reinterpret_cast<char*>(&tag), sizeof(tag));
+            file.seekg(48 + 24 * s + 8);
+            file.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+            if (tag != 3) continue; // Targets
+            const int bad = 1 << 30;
+            file.seekp(offset);
+            file.write(reinterpret_cast<const char*>(&bad), sizeof(bad));
+        }
+    }
+    EXPECT_FALSE(CompactGraph::load(path, corrupt, false));
+    std::remove(path.c_str());
+}
+
+// Duplicate names resolve to the smallest ID, also after renames
+TEST(GraphTest, FindIdByNameDeterministic) {
+    Graph g;
+    g.addNode(7, "park", 0, 0);
+    g.addNode(3, "park", 1, 1);
+    g.addNode(5, "school", 2, 2);
+    EXPECT_EQ(g.findIdByName("park"), 3);
+
+    g.addNode(3, "library", 1, 1); // Overwrite renames node 3
+    EXPECT_EQ(g.findIdByName("park"), 7);
+    EXPECT_EQ(g.findIdByName("library"), 3);
+    EXPECT_EQ(g.findIdByName("nowhere"), -1);
+}
+
+// Exact and prefix lookups on a frozen graph
+TEST(NameIndexTest, ExactAndPrefix) {
+    Graph g;
+    g.addNode(1, "main street", 0, 0);
+    g.addNode(2, "main square", 0, 0);
+    g.addNode(3, "maple avenue", 0, 0);
+    g.addNode(4, "main street", 0, 0);
+    g.addNode(5, "harbor", 0, 0);
+    g.addNode(6, "main", 0, 0);
+
+    NameIndex index(g.freeze());
+    EXPECT_EQ(index.find("main street"), 1);
+    EXPECT_EQ(index.findAll("main street"), (std::vector<int>{1, 4}));
+    EXPECT_EQ(index.find("main st"), -1);
+
+    auto matches = index.complete("main", 10);
+    ASSERT_EQ(matches.size(), 3);
+    EXPECT_EQ(matches[0].name, "main"); // Exact match first
+    EXPECT_EQ(matches[1].name, "main square");
+    EXPECT_EQ(matches[2].name, "main street");
+    EXPECT_EQ(matches[2].id, 1);
+    EXPECT_EQ(matches[2].count, 2);
+
+    EXPECT_EQ(index.complete("ma", 2).size(), 2);
+    EXPECT_EQ(index.complete("map", 5).size(), 1);
+    EXPECT_TRUE(index.complete("zoo", 5).empty());
+    EXPECT_EQ(index.complete("", 100).size(), 5); // Distinct names
+
+    // Reversed dense order: ties still go to the smallest ID
+    NameIndex reversed(g.freeze().permuted({5, 4, 3, 2, 1, 0}));
+    EXPECT_EQ(reversed.find("main street"), 1);
+    EXPECT_EQ(reversed.findAll("main street"), (std::vector<int>{1, 4}));
+    EXPECT_EQ(reversed.complete("main s", 2)[1].id, 1);
+}
+
+// k-d tree queries agree with a brute-force scan
+TEST(SpatialIndexTest, MatchesBruteForce) {
+    Graph g = makeRandomGraph(500, 0, 21);
+    SpatialIndex index(g.freeze());
+    ASSERT_EQ(index.size(), 500);
+
+    auto distTo = [&](int id, double x, double y) {
+        const Node* node = g.getNode(id);
+        return std::hypot(node->x - x, node->y - y);
+    };
+
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> coord(-0.1, 0.6);
+    for (int q = 0; q < 50; ++q) {
+        double x = coord(rng), y = coord(rng);
+
+        // Brute force: all IDs by distance
+        std::vector<int> all;
+        for (const auto& [id, node] : g.getAllNodes()) all.push_back(id);
+        std::sort(all.begin(), all.end(), [&](int a, int b) { return distTo(a, x, y) < distTo(b, x, y); });
+
+        EXPECT_EQ(index.nearest(x, y), all[0]);
+        EXPECT_EQ(index.kNearest(x, y, 5), std::vector<int>(all.begin(), all.begin() + 5));
+
+        auto inRadius = index.withinRadius(x, y, 0.05);
+        size_t expected = std::count_if(all.begin(), all.end(), [&](int id) { return distTo(id, x, y) <= 0.05; });
+        EXPECT_EQ(inRadius.size(), expected);
+
+        auto inBox = index.withinBox(x - 0.05, y - 0.02, x + 0.05, y + 0.02);
+        size_t expectedBox = std::count_if(all.begin(), all.end(), [&](int id) {
+            const Node* node = g.getNode(id);
+            return std::abs(node->x - x) <= 0.05 && std::abs(node->y - y) <= 0.02;
+        });
+        EXPECT_EQ(inBox.size(), expectedBox);
+    }
+
+    EXPECT_EQ(index.nearest(10.0, 10.0, 1.0), -1); // Nothing within range
+    EXPECT_EQ(SpatialIndex().nearest(0, 0), -1);
+}
+
+// Generators are reproducible and keep the Euclidean heuristic exact
+TEST(GeneratorsTest, ShapesAndDeterminism) {
+    Graph grid = Generators::grid(10, 5, 3);
+    EXPECT_EQ(grid.getAllNodes().size(), 50);
+    EXPECT_EQ(grid.freeze().numEdges(), 2 * (9 * 5 + 10 * 4));
+
+    Graph scaleFree = Generators::scaleFree(300, 2, 3);
+    EXPECT_EQ(scaleFree.freeze().numEdges(), 2 * (1 + 298 * 2)); // 3-clique core, then 2 per node
+
+    CompactGraph a = Generators::randomGeometric(400, 6.0, 9).freeze();
+    CompactGraph b = Generators::randomGeometric(400, 6.0, 9).freeze();
+    ASSERT_EQ(a.numEdges(), b.numEdges());
+    for (uint32_t e = 0; e < a.numEdges(); ++e) {
+        EXPECT_EQ(a.target(e), b.target(e));
+        EXPECT_EQ(a.weight(e), b.weight(e));
+    }
+
+    // Every edge at least as long as the straight line
+    for (int u = 0; u < static_cast<int>(a.numNodes()); ++u) {
+        for (uint32_t e = a.edgeBegin(u); e < a.edgeEnd(u); ++e) {
+            int v = a.target(e);
+            EXPECT_GE(a.weight(e), std::hypot(a.x(u) - a.x(v), a.y(u) - a.y(v)));
+        }
+    }
+}
+
+// Stats stay zero unless asked for, and feed the global aggregator when they are
+TEST(SearchStatsTest, CountersAndAggregator) {
+    CompactGraph cg = Generators::grid(20, 20, 5).freeze();
+    StatsAggregator::global().reset();
+
+    auto quiet = Router::computePath(cg, 1, 400);
+    ASSERT_TRUE(quiet.success);
+    EXPECT_EQ(quiet.stats.settled, 0u);
+    EXPECT_EQ(StatsAggregator::global().queries("astar"), 0u);
+
+    RouteOptions options;
+    options.collectStats = true;
+    auto result = Router::computePath(cg, 1, 400, options);
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.path, quiet.path);
+    EXPECT_GT(result.stats.settled, 0u);
+    EXPECT_GE(result.stats.pushes, result.stats.settled);
+    EXPECT_GE(result.stats.relaxations, result.stats.settled);
+    EXPECT_GT(result.stats.peakQueueSize, 0u);
+    EXPECT_GE(result.stats.searchMicros, 0.0);
+
+    options.bidirectional = true;
+    auto bidirectional = Router::computePath(cg, 1, 400, options);
+    EXPECT_NEAR(bidirectional.totalDist, result.totalDist, 1e-9);
+    EXPECT_GT(bidirectional.stats.settled, 0u);
+
+    ContractionHierarchy ch = ContractionHierarchy::build(cg);
+    auto chResult = ch.query(1, 400, true);
+    EXPECT_NEAR(chResult.totalDist, result.totalDist, 1e-9);
+    EXPECT_GT(chResult.stats.settled, 0u);
+    EXPECT_LT(chResult.stats.settled, result.stats.settled);
+
+    EXPECT_EQ(StatsAggregator::global().queries("astar"), 1u);
+    EXPECT_EQ(StatsAggregator::global().queries("bidirectional_astar"), 1u);
+    EXPECT_EQ(StatsAggregator::global().totals("ch").settled, chResult.stats.settled);
+
+    std::string text = StatsAggregator::global().prometheus();
+    EXPECT_NE(text.find("routeplanner_settled_total{engine=\"astar\"}"), std::string::npos);
+    EXPECT_NE(text.find("phase=\"search\""), std::string::npos);
+
+    auto trivial = Router::computePath(cg, 7, 7, options);
+    EXPECT_TRUE(trivial.success);
+    EXPECT_GT(trivial.stats.setupMicros, 0.0); // Setup phase still closed on the early return
+
+    // Same for unknown start or end IDs, on every engine
+    for (bool bidirectionalSearch : {false, true}) {
+        options.bidirectional = bidirectionalSearch;
+        for (auto ends : {std::make_pair(999, 1), std::make_pair(1, 999)}) {
+            auto unknown = Router::computePath(cg, ends.first, ends.second, options);
+            EXPECT_FALSE(unknown.success);
+            EXPECT_GT(unknown.stats.setupMicros, 0.0);
+        }
+    }
+    auto unknownCh = ch.query(1, 999, true);
+    EXPECT_FALSE(unknownCh.success);
+    EXPECT_GT(unknownCh.stats.setupMicros, 0.0);
+    StatsAggregator::global().reset();
+}
+
+// Every frontier pops in key order, and the indexed heap keeps one entry per node
+TEST(PriorityQueueTest, PoliciesPopInOrder) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    std::vector<QueueEntry> storage;
+    BinaryHeap binary(storage);
+    FourAryHeap fourAry;
+    RadixHeap radix;
+    binary.clear(50);
+    fourAry.clear(50);
+    radix.clear(50);
+
+    std::vector<double> keys(50);
+    for (int i = 0; i < 50; ++i) {
+        keys[i] = dist(rng);
+        binary.push(i, keys[i]);
+        fourAry.push(i, keys[i]);
+        radix.push(i, keys[i]);
+    }
+    fourAry.push(7, keys[7] + 1.0); // Not lower, ignored
+    keys[3] = 0.5;
+    fourAry.push(3, keys[3]); // Decrease-key
+    EXPECT_EQ(fourAry.size(), 50u);
+
+    double lastBinary = 0.0, lastFourAry = 0.0, lastRadix = 0.0;
+    while (!radix.empty()) {
+        QueueEntry b = binary.pop(), f = fourAry.pop(), r = radix.pop();
+        EXPECT_GE(b.key, lastBinary);
+        EXPECT_GE(f.key, lastFourAry);
+        EXPECT_GE(r.key, lastRadix);
+        EXPECT_EQ(f.key, keys[f.id]);
+        lastBinary = b.key;
+        lastFourAry = f.key;
+        lastRadix = r.key;
+    }
+    EXPECT_TRUE(binary.empty());
+    EXPECT_TRUE(fourAry.empty());
+}
+
+// Every queue policy gives the same costs in every search mode
+TEST(RouterTest, QueuePoliciesMatchBinaryHeap) {
+    Graph g = makeRandomGraph(80, 250, 53);
+    CompactGraph cg = g.freeze();
+    Landmarks lm = Landmarks::select(cg, 3);
+
+    for (auto queue : {QueueType::FourAryHeap, QueueType::RadixHeap}) {
+        for (auto heuristic : {HeuristicType::Zero, HeuristicType::Landmark}) {
+            for (bool bidirectional : {false, true}) {
+                RouteOptions expectedOptions;
+                expectedOptions.heuristic = heuristic;
+                expectedOptions.landmarks = &lm;
+                expectedOptions.bidirectional = bidirectional;
+                RouteOptions options = expectedOptions;
+                options.queue = queue;
+                options.collectStats = true;
+
+                for (int s = 1; s <= 80; s += 7) {
+                    for (int t = 1; t <= 80; t += 3) {
+                        auto expected = Router::computePath(cg, s, t, expectedOptions);
+                        auto result = Router::computePath(cg, s, t, options);
+                        ASSERT_EQ(result.success, expected.success) << s << " -> " << t;
+                        if (!result.success) continue;
+                        EXPECT_NEAR(result.totalDist, expected.totalDist, 1e-9);
+                        EXPECT_NEAR(pathLength(g, result.path), result.totalDist, 1e-9);
+                        if (queue == QueueType::FourAryHeap) {
+                            EXPECT_LE(result.stats.peakQueueSize, cg.numNodes());
+                        }
+                    }
+                }
+            }
+        }
+    }
+    StatsAggregator::global().reset();
+}
+
+// Repeats are served from the cache until the graph changes
+TEST(RouteCacheTest, HitsAndVersionInvalidation) {
+    Graph g = Generators::grid(10, 10, 3);
+    uint64_t before = g.getVersion();
+    CompactGraph cg = g.freeze();
+    EXPECT_EQ(cg.version(), before);
+
+    RouteCache cache(1 << 20, 4);
+    auto first = cache.computePath(cg, 1, 100);
+    auto second = cache.computePath(cg, 1, 100);
+    EXPECT_EQ(first.path, second.path);
+    EXPECT_EQ(cache.stats().hits, 1u);
+    EXPECT_EQ(cache.stats().misses, 1u);
+
+    // Other options are a different entry
+    RouteOptions dijkstra;
+    dijkstra.heuristic = HeuristicType::Zero;
+    cache.computePath(cg, 1, 100, dijkstra);
+    EXPECT_EQ(cache.stats().misses, 2u);
+
+    // Shortcut straight to the target: the old route must not come back
+    g.addEdge(1, 100, 0.5);
+    EXPECT_NE(g.getVersion(), before);
+    CompactGraph changed = g.freeze();
+    auto updated = cache.computePath(changed, 1, 100);
+    EXPECT_EQ(updated.path, (std::vector<int>{1, 100}));
+    EXPECT_EQ(cache.stats().misses, 3u);
+
+    // Tiny budget keeps only a few entries
+    RouteCache small(2048, 1);
+    for (int t = 1; t <= 100; ++t) small.computePath(cg, 1, t);
+    RouteCacheStats stats = small.stats();
+    EXPECT_LE(stats.bytes, 2048u);
+    EXPECT_GT(stats.evictions, 0u);
+    EXPECT_EQ(stats.entries + stats.evictions, 100u);
+}
+
+// Cost of 'path' on a CompactGraph, cheapest parallel edge per hop
+static double pathLength(const CompactGraph& cg, const std::vector<int>& path) {
+    double total = 0.0;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        int u = cg.indexOf(path[i]), v = cg.indexOf(path[i + 1]);
+        double best = std::numeric_limits<double>::infinity();
+        for (uint32_t e = cg.edgeBegin(u); e < cg.edgeEnd(u); ++e) {
+            if (cg.target(e) == v) best = std::min(best, cg.weight(e));
+        }
+        total += best;
+    }
+    return total;
+}
+
+// Updates land in a new snapshot; readers keep a consistent one throughout
+TEST(LiveGraphTest, UpdatesPublishNewSnapshots) {
+    LiveGraph live(Generators::grid(12, 12, 7).freeze());
+    auto before = live.snapshot();
+    auto oldRoute = live.computePath(1, 144);
+    ASSERT_TRUE(oldRoute.success);
+
+    // Jam the first hop of the current route in both directions
+    int a = oldRoute.path[0], b = oldRoute.path[1];
+    EXPECT_EQ(live.applyUpdates({{a, b, 1000.0}, {b, a, 1000.0}, {1, 9999, 1.0}}), 2u);
+    auto after = live.snapshot();
+    EXPECT_NE(after->version(), before->version());
+    EXPECT_NE(after->weightData(), before->weightData());
+    EXPECT_EQ(after->targetData(), before->targetData()); // Topology shared
+
+    auto newRoute = live.computePath(1, 144);
+    EXPECT_NE(newRoute.path[1], b);
+    EXPECT_NEAR(pathLength(*before, oldRoute.path), oldRoute.totalDist, 1e-9); // Old snapshot untouched
+
+    // Bidirectional search reads the reverse CSR, which must carry the update too
+    RouteOptions bidirectional;
+    bidirectional.bidirectional = true;
+    EXPECT_NEAR(live.computePath(1, 144, bidirectional).totalDist, newRoute.totalDist, 1e-9);
+    EXPECT_THROW(live.applyUpdates({{a, b, -1.0}}), std::invalid_argument);
+
+    // Landmark bounds from before the update may overestimate now: rejected, not used
+    Landmarks stale = Landmarks::select(*before, 4);
+    RouteOptions alt;
+    alt.heuristic = HeuristicType::Landmark;
+    alt.landmarks = &stale;
+    EXPECT_THROW(live.computePath(1, 144, alt), std::invalid_argument);
+    Landmarks fresh = Landmarks::select(*live.snapshot(), 4);
+    alt.landmarks = &fresh;
+    EXPECT_NEAR(live.computePath(1, 144, alt).totalDist, newRoute.totalDist, 1e-9);
+
+    // Readers racing a writer always see a route that is exact on their own snapshot
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&, r]() {
+            int t = 100 + r;
+            while (!done) {
+                auto graph = live.snapshot();
+                auto result = Router::computePath(*graph, 1, t);
+                if (!result.success || std::abs(pathLength(*graph, result.path) - result.totalDist) > 1e-9) ++bad;
+            }
+        });
+    }
+    std::mt19937 rng(5);
+    for (int batch = 0; batch < 50; ++batch) {
+        std::vector<WeightUpdate> updates;
+        for (int i = 0; i < 20; ++i) {
+            int u = 1 + rng() % 143;
+            updates.push_back({u, u + 1, 1.0 + (rng() % 100) / 10.0});
+        }
+        live.applyUpdates(updates);
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(bad, 0);
+}
+
+// Every request gets exactly one tagged answer, matching a direct query
+TEST(RouteServerTest, AnswersEveryRequest) {
+    CompactGraph cg = Generators::grid(15, 15, 2).freeze();
+    std::ostringstream requests;
+    for (int i = 0; i < 200; ++i) requests << "q" << i << " " << 1 + i % 225 << " " << 225 - i % 100 << "\n";
+    requests << "\n# comment\nbad 1\nmissing 1 999\n";
+
+    // Tiny queue and batches, so the reader has to wait on the workers
+    ServerOptions options;
+    options.workers = 4;
+    options.queueCapacity = 1;
+    options.batchSize = 3;
+    std::istringstream in(requests.str());
+    std::ostringstream out;
+    EXPECT_EQ(RouteServer::serve(cg, in, out, options), 202u);
+
+    std::map<std::string, std::string> answers;
+    std::istringstream lines(out.str());
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::string tag = line.substr(0, line.find(' '));
+        EXPECT_EQ(answers.count(tag), 0u) << tag;
+        answers[tag] = line.substr(tag.size() + 1);
+    }
+    ASSERT_EQ(answers.size(), 202u);
+    EXPECT_EQ(answers["bad"].rfind("error", 0), 0u);
+    EXPECT_EQ(answers["missing"], "error unknown node 999");
+
+    for (int i = 0; i < 200; i += 17) {
+        auto expected = Router::computePath(cg, 1 + i % 225, 225 - i % 100);
+        std::istringstream fields(answers["q" + std::to_string(i)]);
+        std::string status;
+        double dist;
+        fields >> status >> dist;
+        ASSERT_EQ(status, "ok");
+        EXPECT_DOUBLE_EQ(dist, expected.totalDist); // Shortest round-trip formatting
+        std::vector<int> path;
+        for (int id; fields >> id;) path.push_back(id);
+        EXPECT_EQ(path, expected.path);
+    }
+}
+
+// Isochrone holds exactly the nodes a full Dijkstra puts within budget
+TEST(RouterTest, ReachableWithinBudget) {
+    Graph g = Generators::grid(20, 20, 4);
+    CompactGraph cg = g.freeze();
+    RouteOptions dijkstra;
+    dijkstra.heuristic = HeuristicType::Zero;
+
+    SearchContext context;
+    for (int source : {1, 210}) {
+        Isochrone iso = Router::reachableWithin(cg, source, 6.0, context, true);
+        ASSERT_EQ(iso.nodes.size(), iso.costs.size());
+        EXPECT_EQ(iso.nodes.front(), source);
+        EXPECT_TRUE(std::is_sorted(iso.costs.begin(), iso.costs.end()));
+
+        std::map<int, double> expected;
+        for (int t = 1; t <= 400; ++t) {
+            auto result = Router::computePath(cg, source, t, dijkstra);
+            if (result.success && result.totalDist <= 6.0) expected[t] = result.totalDist;
+        }
+        ASSERT_EQ(iso.nodes.size(), expected.size());
+        for (size_t i = 0; i < iso.nodes.size(); ++i) EXPECT_NEAR(iso.costs[i], expected[iso.nodes[i]], 1e-9);
+
+        // Hull contains every reached node: no point strictly right of a CCW edge
+        ASSERT_GE(iso.boundaryX.size(), 3u);
+        size_t h = iso.boundaryX.size();
+        for (int id : iso.nodes) {
+            const Node* node = g.getNode(id);
+            for (size_t i = 0; i < h; ++i) {
+                size_t j = (i + 1) % h;
+                double cross = (iso.boundaryX[j] - iso.boundaryX[i]) * (node->y - iso.boundaryY[i])
+                    - (iso.boundaryY[j] - iso.boundaryY[i]) * (node->x - iso.boundaryX[i]);
+                EXPECT_GE(cross, -1e-9);
+            }
+        }
+    }
+
+    EXPECT_TRUE(Router::reachableWithin(cg, 9999, 5.0).nodes.empty());
+    EXPECT_EQ(Router::reachableWithin(g, 1, 0.0).nodes, std::vector<int>{1});
+}
+
+// Reordering changes the layout only: IDs, names and routes stay the same
+TEST(NodeOrderTest, PermutedGraphAnswersTheSame) {
+    CompactGraph original = Generators::randomGeometric(500, 6.0, 8).freeze();
+    std::string path = ::testing::TempDir() + "route_planner_reordered.snap";
+
+    for (auto order : {NodeOrder::Hilbert, NodeOrder::BreadthFirst, NodeOrder::CuthillMcKee}) {
+        std::vector<int> permutation = NodeOrdering::compute(original, order);
+        std::vector<int> sorted = permutation;
+        std::sort(sorted.begin(), sorted.end());
+        for (int i = 0; i < 500; ++i) ASSERT_EQ(sorted[i], i);
+
+        CompactGraph reordered = original.permuted(permutation);
+        ASSERT_EQ(reordered.numEdges(), original.numEdges());
+        for (int i = 0; i < 500; ++i) {
+            int id = reordered.idOf(i);
+            EXPECT_EQ(reordered.indexOf(id), i);
+            EXPECT_EQ(reordered.name(i), original.name(original.indexOf(id)));
+        }
+        EXPECT_EQ(reordered.indexOf(0), -1);
+
+        ASSERT_TRUE(reordered.save(path));
+        CompactGraph loaded;
+        ASSERT_TRUE(CompactGraph::load(path, loaded));
+        EXPECT_EQ(loaded.layout(), reordered.layout());
+        ContractionHierarchy ch = ContractionHierarchy::build(reordered);
+        for (int s = 1; s <= 500; s += 61) {
+            for (int t = 1; t <= 500; t += 37) {
+                auto expected = Router::computePath(original, s, t);
+                auto result = Router::computePath(reordered, s, t);
+                ASSERT_EQ(result.success, expected.success);
+                EXPECT_NEAR(result.totalDist, expected.totalDist, 1e-9);
+                EXPECT_NEAR(Router::computePath(loaded, s, t).totalDist, expected.totalDist, 1e-9);
+                EXPECT_NEAR(ch.query(s, t).totalDist, expected.totalDist, 1e-9);
+            }
+        }
+    }
+    std::remove(path.c_str());
+
+    // Landmarks hold dense indices: ones from before the reorder must be rejected, not misread
+    Landmarks stale = Landmarks::select(original, 4);
+    CompactGraph reordered = NodeOrdering::apply(original, NodeOrder::Hilbert);
+    ASSERT_NE(reordered.layout(), original.layout());
+    RouteOptions alt;
+    alt.heuristic = HeuristicType::Landmark;
+    alt.landmarks = &stale;
+    EXPECT_THROW(Router::computePath(reordered, 1, 2, alt), std::invalid_argument);
+    Landmarks fresh = Landmarks::select(reordered, 4);
+    alt.landmarks = &fresh;
+    EXPECT_NEAR(Router::computePath(reordered, 1, 2, alt).totalDist, Router::computePath(original, 1, 2).totalDist, 1e-9);
+
+    EXPECT_THROW(original.permuted({0, 0}), std::invalid_argument);
+}
+
+// Compressed store decodes to the same edges, rounded up by less than one unit
+TEST(CompressedGraphTest, MatchesCompactGraphWithinResolution) {
+    // One-way random edges and a two-way road network
+    for (const Graph& g : {makeRandomGraph(300, 1500, 21), Generators::randomGeometric(500, 6.0, 4)}) {
+        CompactGraph cg = g.freeze();
+        CompressedGraph compressed(cg, 0.001);
+        ASSERT_EQ(compressed.numNodes(), cg.numNodes());
+        EXPECT_EQ(compressed.resolution(), 0.001);
+
+        for (int i = 0; i < static_cast<int>(cg.numNodes()); ++i) {
+            std::vector<std::pair<int, double>> expected, decoded;
+            for (uint32_t e = cg.edgeBegin(i); e < cg.edgeEnd(i); ++e) expected.emplace_back(cg.target(e), cg.weight(e));
+            compressed.forEachOutEdge(i, [&](int target, double weight) { decoded.emplace_back(target, weight); });
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(decoded.size(), expected.size());
+            for (size_t k = 0; k < decoded.size(); ++k) {
+                EXPECT_EQ(decoded[k].first, expected[k].first);
+                EXPECT_GE(decoded[k].second, expected[k].second);
+                EXPECT_LE(decoded[k].second, expected[k].second + 0.001);
+            }
+
+            size_t inDegree = 0;
+            compressed.forEachInEdge(i, [&](int, double) { ++inDegree; });
+            EXPECT_EQ(inDegree, cg.inEdgeEnd(i) - cg.inEdgeBegin(i));
+        }
+
+        for (int s = 1; s <= 300; s += 23) {
+            for (int t = 1; t <= 300; t += 17) {
+                auto expected = Router::computePath(cg, s, t);
+                for (bool bidirectional : {false, true}) {
+                    RouteOptions options;
+                    options.bidirectional = bidirectional;
+                    auto result = Router::computePath(compressed, s, t, options);
+                    ASSERT_EQ(result.success, expected.success);
+                    if (!expected.success) continue;
+                    EXPECT_GE(result.totalDist, expected.totalDist - 1e-9);
+                    EXPECT_LE(result.totalDist, expected.totalDist + 0.001 * expected.path.size());
+                }
+            }
+        }
+    }
+
+    // Two-way roads are stored once per endpoint: well under CompactGraph's 24 bytes per edge
+    CompactGraph roads = Generators::randomGeometric(2000, 6.0, 5).freeze();
+    CompressedGraph compressed(roads);
+    EXPECT_LT(compressed.edgeBytes(), roads.numEdges() * 8);
+
+    EXPECT_THROW(CompressedGraph(roads, 1e-12), std::invalid_argument);
+}
+
+// Every instantiated policy combination answers as Router::computePath with the same engine
+TEST(BasicRouterTest, PoliciesMatchRouter) {
+    Graph g = Generators::randomGeometric(400, 6.0, 9);
+    CompactGraph cg = g.freeze();
+    CompressedGraph compressed(cg, 0.001);
+    RouteOptions dijkstra;
+    dijkstra.heuristic = HeuristicType::Zero;
+
+    for (int s = 1; s <= 400; s += 37) {
+        for (int t = 1; t <= 400; t += 29) {
+            for (bool euclidean : {false, true}) {
+                const RouteOptions options = euclidean ? RouteOptions{} : dijkstra;
+                auto expected = Router::computePath(cg, s, t, options);
+                auto expectedCompressed = Router::computePath(compressed, s, t, options);
+
+                auto path = euclidean ? BasicRouter<CompactGraph, EuclideanBound>::computePath(cg, s, t)
+                                      : BasicRouter<CompactGraph, ZeroBound>::computePath(cg, s, t);
+                double distance = euclidean
+                    ? BasicRouter<CompactGraph, EuclideanBound, double, DistanceOnly>::computePath(cg, s, t)
+                    : BasicRouter<CompactGraph, ZeroBound, double, DistanceOnly>::computePath(cg, s, t);
+                auto codePath = euclidean
+                    ? BasicRouter<CompressedGraph, EuclideanBound, uint32_t>::computePath(compressed, s, t)
+                    : BasicRouter<CompressedGraph, ZeroBound, uint32_t>::computePath(compressed, s, t);
+                double codeDistance = euclidean
+                    ? BasicRouter<CompressedGraph, EuclideanBound, uint32_t, DistanceOnly>::computePath(compressed, s, t)
+                    : BasicRouter<CompressedGraph, ZeroBound, uint32_t, DistanceOnly>::computePath(compressed, s, t);
+
+                ASSERT_EQ(path.success, expected.success) << s << " -> " << t;
+                EXPECT_EQ(codePath.success, expected.success);
+                if (!expected.success) {
+                    EXPECT_TRUE(std::isinf(distance));
+                    EXPECT_TRUE(std::isinf(codeDistance));
+                    continue;
+                }
+                EXPECT_EQ(path.path, expected.path);
+                EXPECT_EQ(path.totalDist, expected.totalDist);
+                EXPECT_EQ(distance, expected.totalDist);
+                // Summed in codes, so only rounding apart from the decoded search
+                EXPECT_NEAR(codePath.totalDist, expectedCompressed.totalDist, 1e-9);
+                EXPECT_NEAR(codeDistance, expectedCompressed.totalDist, 1e-9);
+                EXPECT_EQ(codePath.path.front(), s);
+                EXPECT_EQ(codePath.path.back(), t);
+            }
+        }
+    }
+    EXPECT_TRUE(std::isinf(BasicRouter<CompactGraph, ZeroBound, double, DistanceOnly>::computePath(cg, 1, 999)));
+}
+
+// Every kernel matches the plain formula bit for bit, tails and gathers included
+TEST(DistanceKernelsTest, BatchMatchesScalarFormula) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+    std::vector<double> xs(1000), ys(1000);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = coord(rng);
+        ys[i] = coord(rng);
+    }
+    std::vector<int> nodes(37);
+    for (int& node : nodes) node = static_cast<int>(rng() % xs.size());
+
+    for (auto isa : {KernelIsa::Scalar, KernelIsa::Avx2}) {
+        for (size_t count : {0, 1, 4, 7, 37}) {
+            std::vector<double> distances(count), squared(count);
+            DistanceKernels::euclidean(isa, xs.data(), ys.data(), nodes.data(), count, 1.5, -2.5, distances.data());
+            DistanceKernels::squaredEuclidean(isa, xs.data(), ys.data(), nodes.data(), count, 1.5, -2.5, squared.data());
+            for (size_t i = 0; i < count; ++i) {
+                double dx = xs[nodes[i]] - 1.5;
+                double dy = ys[nodes[i]] + 2.5;
+                EXPECT_EQ(squared[i], dx * dx + dy * dy);
+                EXPECT_EQ(distances[i], std::sqrt(dx * dx + dy * dy));
+            }
+        }
+    }
+
+    // A* batches the heuristic on hubs; routes must not change
+    CompactGraph hubs = Generators::scaleFree(2000, 3, 9).freeze();
+    RouteOptions dijkstra;
+    dijkstra.heuristic = HeuristicType::Zero;
+    for (int s = 1; s <= 2000; s += 97) {
+        for (int t = 2; t <= 2000; t += 89) {
+            auto expected = Router::computePath(hubs, s, t, dijkstra);
+            auto result = Router::computePath(hubs, s, t);
+            ASSERT_EQ(result.success, expected.success);
+            EXPECT_NEAR(result.totalDist, expected.totalDist, 1e-9);
+        }
+    }
+}
+
+// Yen's k-shortest against brute-force enumeration of every simple path
+TEST(RouterTest, KShortestPathsMatchEnumeration) {
+    for (unsigned seed : {5u, 6u, 7u}) {
+        Graph g = makeRandomGraph(10, 35, seed);
+        CompactGraph cg = g.freeze();
+
+        for (int s = 1; s <= 10; s += 3) {
+            for (int t = 2; t <= 10; t += 4) {
+                // Costs of all loopless s -> t paths, cheapest edge per hop
+                std::vector<double> costs;
+                std::vector<int> stack = {s};
+                std::function<void(double)> walk = [&](double cost) {
+                    int node = stack.back();
+                    if (node == t) {
+                        costs.push_back(cost);
+                        return;
+                    }
+                    std::map<int, double> next;
+                    for (const auto& edge : g.getNode(node)->neighbors) {
+                        auto it = next.find(edge.targetNodeID);
+                        if (it == next.end() || edge.distance < it->second) next[edge.targetNodeID] = edge.distance;
+                    }
+                    for (const auto& [v, w] : next) {
+                        if (std::find(stack.begin(), stack.end(), v) != stack.end()) continue;
+                        stack.push_back(v);
+                        walk(cost + w);
+                        stack.pop_back();
+                    }
+                };
+                walk(0.0);
+                std::sort(costs.begin(), costs.end());
+
+                auto routes = Router::kShortestPaths(cg, s, t, 6);
+                ASSERT_EQ(routes.size(), std::min<size_t>(6, costs.size()));
+                std::set<std::vector<int>> distinct;
+                for (size_t i = 0; i < routes.size(); ++i) {
+                    EXPECT_NEAR(routes[i].totalDist, costs[i], 1e-9);
+                    EXPECT_NEAR(pathLength(g, routes[i].path), routes[i].totalDist, 1e-9);
+                    std::set<int> visited(routes[i].path.begin(), routes[i].path.end());
+                    EXPECT_EQ(visited.size(), routes[i].path.size()); // Loopless
+                    EXPECT_TRUE(distinct.insert(routes[i].path).second);
+                }
+            }
+        }
+    }
+
+    CompactGraph cg = makeRandomGraph(10, 35, 5).freeze();
+    EXPECT_TRUE(Router::kShortestPaths(cg, 1, 999, 3).empty());
+    EXPECT_TRUE(Router::kShortestPaths(cg, 1, 2, 0).empty());
+    ASSERT_EQ(Router::kShortestPaths(cg, 4, 4, 3).size(), 1u);
+}
+
+// Cancellation and progress hooks, and the async router built on them
+TEST(AsyncRouterTest, SupersedesAndCancels) {
+    CompactGraph cg = Generators::grid(80, 80, 2).freeze();
+    const int corner = 1, opposite = 80 * 80;
+    auto expected = Router::computePath(cg, corner, opposite);
+    ASSERT_TRUE(expected.success);
+
+    // Progress reports every expanded node exactly once
+    SearchContext context;
+    RouteOptions options;
+    std::vector<int> reported;
+    options.onProgress = [&](const std::vector<int>& ids) { reported.insert(reported.end(), ids.begin(), ids.end()); };
+    EXPECT_NEAR(Router::computePath(cg, corner, opposite, options, context).totalDist, expected.totalDist, 1e-9);
+    EXPECT_EQ(reported.size(), context.numSettled());
+
+    // A raised flag stops the search, and the cache doesn't keep the non-answer
+    std::atomic<bool> cancel{true};
+    options.cancel = &cancel;
+    for (bool bidirectional : {false, true}) {
+        options.bidirectional = bidirectional;
+        EXPECT_FALSE(Router::computePath(cg, corner, opposite, options).success);
+    }
+    RouteCache cache;
+    options.bidirectional = false;
+    EXPECT_FALSE(cache.computePath(cg, corner, opposite, options).success);
+    cancel = false;
+    EXPECT_TRUE(cache.computePath(cg, corner, opposite, options).success);
+
+    // Searches that hold on their first progress report until the test lets them go,
+    // so cancellation always lands mid-search
+    AsyncRouter router(cg);
+    std::atomic<bool> gate{false};
+    RouteOptions held;
+    held.onProgress = [&](const std::vector<int>&) {
+        while (!gate) std::this_thread::yield();
+    };
+
+    RouteHandle first = router.submit(corner, opposite, held);
+    RouteHandle second = router.submit(opposite, corner); // Supersedes 'first'
+    gate = true;
+    auto result = second.get();
+    ASSERT_TRUE(result.success);
+    EXPECT_NEAR(result.totalDist, expected.totalDist, 1e-9);
+    EXPECT_TRUE(first.cancelled());
+    ASSERT_TRUE(first.ready());
+    EXPECT_FALSE(first.get().success);
+    EXPECT_FALSE(second.takeProgress().empty());
+
+    gate = false;
+    RouteHandle third = router.submit(corner, opposite, held);
+    third.cancel();
+    gate = true;
+    third.wait();
+    EXPECT_FALSE(third.get().success);
+
+    // Exceptions reach the caller
+    RouteOptions badLandmarks;
+    badLandmarks.heuristic = HeuristicType::Landmark;
+    EXPECT_THROW(router.submit(corner, opposite, badLandmarks).get(), std::invalid_argument);
+}